@@ -0,0 +1,567 @@
+/**
+ * Golden output renders for DSP classes.
+ *
+ * Every case drives a single class with deterministic input and fixed
+ * parameter automation. Renders can be stored as reference WAV files and
+ * later compared against new renders, so that optimized kernels can be
+ * checked for changing the sound.
+ *
+ * Usage:
+ *   GoldenRender render reference_dir [case ...]
+ *   GoldenRender compare reference_dir [-e max_abs_error] [-d spectral_distance_db] [case ...]
+ *
+ * Comparison reports maximal absolute sample error and log-spectral
+ * distance (dB) for every case as JSON, exit code is non-zero if any
+ * case exceeds tolerances.
+ */
+
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Patch.h"
+#include "DattorroReverb.hpp"
+#include "DattorroBlockReverb.hpp"
+#include "PolygonalOscillator.hpp"
+#include "DiscreteSummationOscillator.hpp"
+#include "Wavefolder.hpp"
+#include "B259Wavefolder.hpp"
+#include "FilterBank.hpp"
+#include "SamplePlayer.hpp"
+
+static constexpr float render_sample_rate = 48000;
+static constexpr size_t render_block_size = 64;
+static constexpr size_t render_blocks = 1500; // 2 seconds
+static constexpr size_t render_channels = 2;
+
+/**
+ * Rendered audio, channels are stored as separate FloatArrays in a single AudioBuffer
+ */
+class Render {
+public:
+    Render()
+        : buffer(AudioBuffer::create(render_channels, render_blocks * render_block_size)) {
+    }
+    ~Render() {
+        AudioBuffer::destroy(buffer);
+    }
+    FloatArray getBlock(size_t channel, size_t block) {
+        return buffer->getSamples(channel).subArray(
+            block * render_block_size, render_block_size);
+    }
+    FloatArray getSamples(size_t channel) {
+        return buffer->getSamples(channel);
+    }
+    AudioBuffer* buffer;
+};
+
+/**
+ * Deterministic noise, same as benchmark input
+ */
+class Noise {
+public:
+    float generate() {
+        seed = seed * 1664525u + 1013904223u;
+        return int32_t(seed) * (1.f / 2147483648.f);
+    }
+
+private:
+    uint32_t seed = 22222;
+};
+
+/**
+ * Parameter automation: triangle LFO going from 0 to 1 and back
+ * over given number of blocks, evaluated at block rate
+ */
+static float automation(size_t block, size_t period) {
+    float t = float(block % period) / period;
+    return t < 0.5f ? t * 2 : 2 - t * 2;
+}
+
+/**
+ * Modulation offsets must fit into delay lines used for modulated reads.
+ * Damping goes from 0.2 up by damping_range percent.
+ */
+template <typename Reverb, const ReverbDelays<10>& delays, size_t offset1, size_t amount1,
+    size_t offset2, size_t amount2, size_t sample_rate = size_t(render_sample_rate),
+    size_t damping_range = 70>
+void renderDattorro(Render& render) {
+    Reverb* reverb = Reverb::create(render_block_size * 2, render_block_size,
+        sample_rate, delays);
+    reverb->setModulation(offset1, amount1, offset2, amount2);
+    AudioBuffer* input = AudioBuffer::create(render_channels, render_block_size);
+    AudioBuffer* output = AudioBuffer::create(render_channels, render_block_size);
+    Noise noise;
+    for (size_t block = 0; block < render_blocks; block++) {
+        reverb->setAmount(0.5f + 0.5f * automation(block, 300));
+        reverb->setDecay(0.5f + 0.45f * automation(block, 700));
+        reverb->setDiffusion(0.3f + 0.6f * automation(block, 500));
+        reverb->setDamping(0.2f + damping_range / 100.f * automation(block, 400));
+        reverb->setPreDelay(automation(block, 200) * render_block_size);
+        // Noise bursts separated by silence to excite the tail
+        bool burst = block % 250 < 20;
+        for (size_t ch = 0; ch < render_channels; ch++) {
+            FloatArray samples = input->getSamples(ch);
+            for (size_t i = 0; i < render_block_size; i++)
+                samples[i] = burst ? 0.5f * noise.generate() : 0.0f;
+        }
+        reverb->process(*input, *output);
+        for (size_t ch = 0; ch < render_channels; ch++)
+            render.getBlock(ch, block).copyFrom(output->getSamples(ch));
+    }
+    AudioBuffer::destroy(input);
+    AudioBuffer::destroy(output);
+    Reverb::destroy(reverb);
+}
+
+/**
+ * Complex oscillators write real part to left channel and imaginary part to right channel
+ */
+static void copyComplex(Render& render, size_t block, ComplexFloatArray samples) {
+    FloatArray left = render.getBlock(0, block);
+    FloatArray right = render.getBlock(1, block);
+    for (size_t i = 0; i < samples.getSize(); i++) {
+        left[i] = samples[i].re;
+        right[i] = samples[i].im;
+    }
+}
+
+void renderPolygonal(Render& render) {
+    PolygonalOscillator* osc = PolygonalOscillator::create(render_sample_rate);
+    ComplexFloatArray out = ComplexFloatArray::create(render_block_size);
+    for (size_t block = 0; block < render_blocks; block++) {
+        osc->setFrequency(55.f * exp2f(automation(block, 1500) * 6));
+        osc->setParams(PolygonalOscillator::NONE, automation(block, 500),
+            automation(block, 350) * 0.5f);
+        osc->setFeedback(automation(block, 900) * M_PI, automation(block, 600) * 0.5f);
+        osc->generate(out);
+        copyComplex(render, block, out);
+    }
+    ComplexFloatArray::destroy(out);
+    PolygonalOscillator::destroy(osc);
+}
+
+template <DSFShape shape, bool use_phasor = false>
+void renderDSF(Render& render) {
+    using Osc = DiscreteSummationOscillator<shape, use_phasor>;
+    Osc* osc = new Osc();
+    osc->setSampleRate(render_sample_rate);
+    ComplexFloatArray out = ComplexFloatArray::create(render_block_size);
+    FloatArray fm = FloatArray::create(render_block_size);
+    Noise noise;
+    for (size_t block = 0; block < render_blocks; block++) {
+        osc->setFrequency(55.f * exp2f(automation(block, 1500) * 5));
+        osc->setA(0.1f + 0.8f * automation(block, 400));
+        osc->setB(0.5f + 2.f * automation(block, 700));
+        osc->setN(1 + int(automation(block, 600) * 16));
+        osc->setFeedback(automation(block, 900) * 0.3f, automation(block, 500) * M_PI);
+        // FM is applied in second half of the render
+        if (block < render_blocks / 2) {
+            osc->generate(out);
+        }
+        else {
+            for (size_t i = 0; i < render_block_size; i++)
+                fm[i] = 0.01f * noise.generate();
+            osc->generate(out, fm);
+        }
+        copyComplex(render, block, out);
+    }
+    FloatArray::destroy(fm);
+    ComplexFloatArray::destroy(out);
+    delete osc;
+}
+
+template <typename Function>
+void renderWavefolder(Render& render) {
+    AntialiasedWaveFolder<Function> folders[render_channels];
+    float phases[render_channels] = {};
+    for (size_t block = 0; block < render_blocks; block++) {
+        // Sine with rising drive, the two channels use different frequencies
+        float gain = 0.5f + 4.f * automation(block, 1500);
+        for (size_t ch = 0; ch < render_channels; ch++) {
+            FloatArray samples = render.getBlock(ch, block);
+            float incr = 2 * M_PI * (110.f * (ch + 1)) / render_sample_rate;
+            for (size_t i = 0; i < render_block_size; i++) {
+                samples[i] = gain * sinf(phases[ch]);
+                phases[ch] += incr;
+            }
+            phases[ch] = fmodf(phases[ch], 2 * M_PI);
+            folders[ch].process(samples, samples);
+        }
+    }
+}
+
+void renderB259Wavefolder(Render& render) {
+    using Folder = B259Wavefolder<render_channels>;
+    Folder* folder = Folder::create(render_sample_rate);
+    AudioBuffer* buffer = AudioBuffer::create(render_channels, render_block_size);
+    float phases[render_channels] = {};
+    for (size_t block = 0; block < render_blocks; block++) {
+        folder->setFold(automation(block, 1500));
+        folder->setOffset(automation(block, 600) * 2 - 1);
+        folder->setLowpass(automation(block, 900));
+        for (size_t ch = 0; ch < render_channels; ch++) {
+            FloatArray samples = buffer->getSamples(ch);
+            float incr = 2 * M_PI * (110.f * (ch + 1)) / render_sample_rate;
+            for (size_t i = 0; i < render_block_size; i++) {
+                samples[i] = sinf(phases[ch]);
+                phases[ch] += incr;
+            }
+            phases[ch] = fmodf(phases[ch], 2 * M_PI);
+        }
+        folder->process(*buffer, *buffer);
+        for (size_t ch = 0; ch < render_channels; ch++)
+            render.getBlock(ch, block).copyFrom(buffer->getSamples(ch));
+    }
+    AudioBuffer::destroy(buffer);
+    Folder::destroy(folder);
+}
+
+/**
+ * Applies different gain to every band
+ */
+class BandGain {
+public:
+    void process(size_t band, FloatArray samples) {
+        samples.multiply(gains[band]);
+    }
+    float gains[4];
+};
+
+void renderFilterBank(Render& render) {
+    using Bank = CrossoverFilterBank<LinkwitzRileySVF, BandGain>;
+    float frequencies[] = { 200.f, 1000.f, 5000.f, 0.f };
+    BandGain gains;
+    Bank* bank = Bank::create(render_sample_rate, frequencies, 4, gains, render_block_size);
+    Noise noise;
+    for (size_t block = 0; block < render_blocks; block++) {
+        for (size_t i = 0; i < 4; i++)
+            gains.gains[i] = automation(block + i * 100, 400);
+        FloatArray left = render.getBlock(0, block);
+        FloatArray right = render.getBlock(1, block);
+        for (size_t i = 0; i < render_block_size; i++)
+            left[i] = 0.5f * noise.generate();
+        right.copyFrom(left);
+        bank->process(left, left);
+    }
+    Bank::destroy(bank);
+}
+
+void renderSamplePlayer(Render& render) {
+    using Player = SamplePlayer<COSINE_INTERPOLATION, CROSSFADE_PARABOLIC, 64, 4>;
+    // Synthetic "sample": decaying chirp, half a second long
+    FloatArray sample = FloatArray::create(render_sample_rate / 2);
+    float phase = 0;
+    for (size_t i = 0; i < sample.getSize(); i++) {
+        float t = float(i) / sample.getSize();
+        sample[i] = sinf(phase) * (1 - t);
+        phase += 2 * M_PI * (100.f + 2000.f * t) / render_sample_rate;
+    }
+    Player* player = Player::create(render_sample_rate, sample, 4.0);
+    player->setLooping(true);
+    for (size_t block = 0; block < render_blocks; block++) {
+        if (block % 100 == 0) {
+            player->setLoopPoint(block / 100);
+            player->trigger();
+        }
+        player->setDuration(size_t(render_sample_rate * (0.25f + 0.5f * automation(block, 700))));
+        FloatArray left = render.getBlock(0, block);
+        player->generate(left);
+        render.getBlock(1, block).copyFrom(left);
+    }
+    Player::destroy(player);
+    FloatArray::destroy(sample);
+}
+
+/**
+ * Cases with a reference are compared against renders of another case, i.e.
+ * alternative implementations that must produce the same output. They have
+ * no reference files of their own. Their max_error is used instead of a
+ * lower tolerance given on command line, as they may use approximations.
+ */
+struct RenderCase {
+    const char* name;
+    void (*render)(Render&);
+    const char* reference = NULL;
+    float max_error = 0;
+};
+
+static const RenderCase cases[] = {
+    { "DattorroReverbClouds",
+        renderDattorro<DattorroReverb<true>, clouds_delays, 10, 60, 4680, 100> },
+    { "DattorroReverbRings",
+        renderDattorro<DattorroReverb<true>, rings_delays, 4460, 40, 6261, 50> },
+    { "DattorroReverbDattorro",
+        renderDattorro<DattorroReverb<true>, dattorro_delays, 10, 16, 672, 16> },
+    { "DattorroBlockReverbClouds",
+        renderDattorro<DattorroBlockReverb<true>, clouds_delays, 10, 60, 4680, 100> },
+    { "DattorroBlockReverbRings",
+        renderDattorro<DattorroBlockReverb<false>, rings_delays, 4460, 40, 6261, 50> },
+    // Patches scale damping by 1.1, tables must stay stable at other rates
+    { "DattorroReverbRingsOverdamped44k",
+        renderDattorro<DattorroReverb<true>, rings_delays, 4460, 40, 6261, 50, 44100, 90> },
+    { "PolygonalOscillator", renderPolygonal },
+    { "DiscreteSummationOscillatorDSF1", renderDSF<DSF1> },
+    { "DiscreteSummationOscillatorDSF2", renderDSF<DSF2> },
+    { "DiscreteSummationOscillatorDSF3", renderDSF<DSF3> },
+    { "DiscreteSummationOscillatorDSF4", renderDSF<DSF4> },
+    { "DiscreteSummationOscillatorPhasorDSF1", renderDSF<DSF1, true>,
+        "DiscreteSummationOscillatorDSF1", 2e-4f },
+    { "DiscreteSummationOscillatorPhasorDSF2", renderDSF<DSF2, true>,
+        "DiscreteSummationOscillatorDSF2", 2e-4f },
+    { "DiscreteSummationOscillatorPhasorDSF3", renderDSF<DSF3, true>,
+        "DiscreteSummationOscillatorDSF3", 2e-4f },
+    { "DiscreteSummationOscillatorPhasorDSF4", renderDSF<DSF4, true>,
+        "DiscreteSummationOscillatorDSF4", 2e-4f },
+    { "AntialiasedWaveFolderHardClip", renderWavefolder<HardClip> },
+    { "AntialiasedWaveFolderCubicSaturator", renderWavefolder<CubicSaturator> },
+    { "B259Wavefolder", renderB259Wavefolder },
+    { "CrossoverFilterBank", renderFilterBank },
+    { "SamplePlayer", renderSamplePlayer },
+};
+
+/**
+ * Renders are stored as 32 bit float WAV to avoid any quantization
+ */
+static bool writeWav(const std::string& path, Render& render) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == NULL)
+        return false;
+    uint32_t frames = render.getSamples(0).getSize();
+    uint32_t data_size = frames * render_channels * sizeof(float);
+    uint32_t riff_size = 36 + data_size;
+    uint32_t fmt_size = 16;
+    uint16_t format = 3; // IEEE float
+    uint16_t channels = render_channels;
+    uint32_t rate = render_sample_rate;
+    uint32_t byte_rate = rate * channels * sizeof(float);
+    uint16_t align = channels * sizeof(float);
+    uint16_t bits = 32;
+    fwrite("RIFF", 1, 4, file);
+    fwrite(&riff_size, 4, 1, file);
+    fwrite("WAVEfmt ", 1, 8, file);
+    fwrite(&fmt_size, 4, 1, file);
+    fwrite(&format, 2, 1, file);
+    fwrite(&channels, 2, 1, file);
+    fwrite(&rate, 4, 1, file);
+    fwrite(&byte_rate, 4, 1, file);
+    fwrite(&align, 2, 1, file);
+    fwrite(&bits, 2, 1, file);
+    fwrite("data", 1, 4, file);
+    fwrite(&data_size, 4, 1, file);
+    for (uint32_t i = 0; i < frames; i++) {
+        for (size_t ch = 0; ch < render_channels; ch++) {
+            float sample = render.getSamples(ch)[i];
+            fwrite(&sample, sizeof(float), 1, file);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * Reads WAV file written by writeWav(), interleaved samples are split
+ * into separate channels
+ */
+static bool readWav(const std::string& path, Render& render) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == NULL)
+        return false;
+    char id[4];
+    uint32_t size;
+    bool found = false;
+    fseek(file, 12, SEEK_SET);
+    while (fread(id, 1, 4, file) == 4 && fread(&size, 4, 1, file) == 1) {
+        if (memcmp(id, "data", 4) == 0) {
+            found = true;
+            break;
+        }
+        fseek(file, size + (size & 1), SEEK_CUR);
+    }
+    uint32_t frames = render.getSamples(0).getSize();
+    if (!found || size != frames * render_channels * sizeof(float)) {
+        fclose(file);
+        return false;
+    }
+    for (uint32_t i = 0; i < frames; i++) {
+        for (size_t ch = 0; ch < render_channels; ch++) {
+            float sample;
+            if (fread(&sample, sizeof(float), 1, file) != 1) {
+                fclose(file);
+                return false;
+            }
+            render.getSamples(ch)[i] = sample;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * In-place radix-2 FFT
+ */
+static void fft(std::vector<std::complex<float>>& x) {
+    size_t n = x.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(x[i], x[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        std::complex<float> w = std::polar(1.f, float(-2 * M_PI / len));
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<float> wn(1.f, 0.f);
+            for (size_t j = 0; j < len / 2; j++) {
+                std::complex<float> u = x[i + j];
+                std::complex<float> v = x[i + j + len / 2] * wn;
+                x[i + j] = u + v;
+                x[i + j + len / 2] = u - v;
+                wn *= w;
+            }
+        }
+    }
+}
+
+static bool isFinite(Render& render) {
+    for (size_t ch = 0; ch < render_channels; ch++) {
+        FloatArray samples = render.getSamples(ch);
+        for (size_t i = 0; i < samples.getSize(); i++) {
+            if (!std::isfinite(samples[i]))
+                return false;
+        }
+    }
+    return true;
+}
+
+static float getMaxAbsError(FloatArray a, FloatArray b) {
+    float error = 0;
+    for (size_t i = 0; i < a.getSize(); i++) {
+        float diff = std::abs(a[i] - b[i]);
+        // NaN must never be accepted
+        if (!(diff <= error))
+            error = std::isnan(diff) ? INFINITY : diff;
+    }
+    return error;
+}
+
+/**
+ * Mean log-spectral distance in dB over Hann windowed frames. Bins more than
+ * 80dB below frame peak are clamped, so that numerical noise in silent parts
+ * of spectrum doesn't dominate the result.
+ */
+static float getSpectralDistance(FloatArray a, FloatArray b) {
+    static constexpr size_t frame_size = 1024;
+    static constexpr size_t hop_size = frame_size / 2;
+    static constexpr float dynamic_range = 1e-4f;
+    std::vector<std::complex<float>> fa(frame_size), fb(frame_size);
+    float total = 0;
+    size_t frames = 0;
+    for (size_t start = 0; start + frame_size <= a.getSize(); start += hop_size) {
+        for (size_t i = 0; i < frame_size; i++) {
+            float w = 0.5f - 0.5f * cosf(2 * M_PI * i / frame_size);
+            fa[i] = a[start + i] * w;
+            fb[i] = b[start + i] * w;
+        }
+        fft(fa);
+        fft(fb);
+        float peak = 1e-6f;
+        for (size_t i = 0; i <= frame_size / 2; i++)
+            peak = std::max(peak, std::max(std::abs(fa[i]), std::abs(fb[i])));
+        float floor = peak * dynamic_range;
+        float sum = 0;
+        for (size_t i = 0; i <= frame_size / 2; i++) {
+            float diff = 20 * log10f(std::max(std::abs(fa[i]), floor)) -
+                20 * log10f(std::max(std::abs(fb[i]), floor));
+            sum += diff * diff;
+        }
+        total += sqrtf(sum / (frame_size / 2 + 1));
+        frames++;
+    }
+    return frames ? total / frames : 0;
+}
+
+static bool isSelected(const char* name, int argc, char** argv, int first) {
+    bool any = false;
+    for (int i = first; i < argc; i++) {
+        if (argv[i][0] == '-') {
+            i++;
+            continue;
+        }
+        any = true;
+        if (strcmp(argv[i], name) == 0)
+            return true;
+    }
+    return !any;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (strcmp(argv[1], "render") && strcmp(argv[1], "compare"))) {
+        fprintf(stderr,
+            "Usage: %s render|compare reference_dir [-e max_abs_error] "
+            "[-d spectral_distance_db] [case ...]\n",
+            argv[0]);
+        return 2;
+    }
+    bool compare = strcmp(argv[1], "compare") == 0;
+    std::string dir = argv[2];
+    float max_error = 1e-5f;
+    float max_distance = 0.5f;
+    for (int i = 3; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0)
+            max_error = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-d") == 0)
+            max_distance = atof(argv[i + 1]);
+    }
+
+    HostPatchContext::get().sample_rate = render_sample_rate;
+    HostPatchContext::get().block_size = render_block_size;
+
+    int failed = 0;
+    for (const RenderCase& rc : cases) {
+        if (!isSelected(rc.name, argc, argv, 3))
+            continue;
+        if (!compare && rc.reference != NULL)
+            continue;
+        std::string path = dir + "/" + (rc.reference ? rc.reference : rc.name) + ".wav";
+        Render render;
+        rc.render(render);
+        if (!isFinite(render)) {
+            printf("{\"case\": \"%s\", \"error\": \"non-finite output\"}\n", rc.name);
+            failed++;
+            continue;
+        }
+        if (!compare) {
+            if (!writeWav(path, render)) {
+                fprintf(stderr, "Can't write %s\n", path.c_str());
+                failed++;
+            }
+            continue;
+        }
+        Render reference;
+        if (!readWav(path, reference)) {
+            printf("{\"case\": \"%s\", \"error\": \"missing reference\"}\n", rc.name);
+            failed++;
+            continue;
+        }
+        float error = 0, distance = 0;
+        for (size_t ch = 0; ch < render_channels; ch++) {
+            error = std::max(error,
+                getMaxAbsError(render.getSamples(ch), reference.getSamples(ch)));
+            distance = std::max(distance,
+                getSpectralDistance(render.getSamples(ch), reference.getSamples(ch)));
+        }
+        bool passed = error <= std::max(max_error, rc.max_error) &&
+            distance <= max_distance;
+        printf("{\"case\": \"%s\", \"max_abs_error\": %g, \"spectral_distance_db\": %g, "
+               "\"passed\": %s}\n",
+            rc.name, error, distance, passed ? "true" : "false");
+        if (!passed)
+            failed++;
+    }
+    return failed ? 1 : 0;
+}
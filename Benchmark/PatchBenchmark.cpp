@@ -0,0 +1,120 @@
+/**
+ * Offline patch benchmark.
+ *
+ * Runs a single patch on host with deterministic input and reports
+ * processing time as JSON. Patch is selected at compile time:
+ *
+ *   -DPATCH_HEADER=\"TZFlangerPatch.hpp\" -DPATCH_CLASS=TZFlangerPatch
+ *
+ * See run_benchmarks.py for building and running every patch in this repo.
+ *
+ * Usage: PatchBenchmark [-sr sample_rate] [-bs block_size] [-n blocks] [-w warmup_blocks]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Patch.h"
+#include PATCH_HEADER
+
+#define STRINGIFY(x) #x
+#define TO_STRING(x) STRINGIFY(x)
+
+// Real-time budget that we report CPU load against
+static constexpr float budget_sample_rate = 48000;
+static constexpr int budget_block_size = 64;
+
+/**
+ * Deterministic input: a slow sine sweep on left channel and white noise
+ * from a fixed LCG seed on right channel. Both are kept at -6 dB.
+ */
+class BenchmarkInput {
+public:
+    BenchmarkInput(float sr)
+        : phase(0)
+        , freq(20)
+        , freq_mul(powf(1000, 1.f / (sr * 10)))
+        , mul(2 * M_PI / sr)
+        , seed(22222) {
+    }
+    void generate(AudioBuffer& buffer) {
+        FloatArray left = buffer.getSamples(LEFT_CHANNEL);
+        FloatArray right = buffer.getSamples(RIGHT_CHANNEL);
+        for (size_t i = 0; i < left.getSize(); i++) {
+            left[i] = 0.5f * sinf(phase);
+            phase += freq * mul;
+            if (phase >= 2 * M_PI)
+                phase -= 2 * M_PI;
+            freq *= freq_mul;
+            if (freq > 20000)
+                freq = 20;
+            seed = seed * 1664525u + 1013904223u;
+            right[i] = 0.5f * (int32_t(seed) * (1.f / 2147483648.f));
+        }
+    }
+
+private:
+    float phase, freq, freq_mul, mul;
+    uint32_t seed;
+};
+
+int main(int argc, char** argv) {
+    HostPatchContext& context = HostPatchContext::get();
+    int blocks = 10000;
+    int warmup = 100;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-sr") == 0)
+            context.sample_rate = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-bs") == 0)
+            context.block_size = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-n") == 0)
+            blocks = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-w") == 0)
+            warmup = atoi(argv[i + 1]);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    PATCH_CLASS* patch = new PATCH_CLASS();
+    double init_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    AudioBuffer* input = AudioBuffer::create(context.channels, context.block_size);
+    AudioBuffer* buffer = AudioBuffer::create(context.channels, context.block_size);
+    BenchmarkInput generator(context.sample_rate);
+
+    double total_ns = 0;
+    double worst_ns = 0;
+    for (int i = -warmup; i < blocks; i++) {
+        generator.generate(*input);
+        buffer->copyFrom(*input);
+        start = Clock::now();
+        patch->processAudio(*buffer);
+        double block_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (i >= 0) {
+            total_ns += block_ns;
+            if (block_ns > worst_ns)
+                worst_ns = block_ns;
+        }
+    }
+
+    double samples = double(blocks) * context.block_size;
+    double ns_per_sample = total_ns / samples;
+    // Time available for a single sample in real time
+    double budget_ns = 1e9 / budget_sample_rate;
+    printf("{\"patch\": \"%s\", \"sample_rate\": %g, \"block_size\": %d, "
+           "\"blocks\": %d, \"errors\": %d, \"init_ms\": %.3f, "
+           "\"ns_per_sample\": %.3f, \"mean_block_ns\": %.1f, \"worst_block_ns\": %.1f, "
+           "\"budget\": \"%gHz/%d\", \"budget_percent\": %.2f, \"worst_budget_percent\": %.2f}\n",
+        TO_STRING(PATCH_CLASS), context.sample_rate, context.block_size,
+        blocks, getErrorCount(), init_ns * 1e-6,
+        ns_per_sample, total_ns / blocks, worst_ns,
+        budget_sample_rate, budget_block_size,
+        100 * ns_per_sample / budget_ns,
+        100 * worst_ns / (context.block_size * budget_ns));
+
+    delete patch;
+    AudioBuffer::destroy(input);
+    AudioBuffer::destroy(buffer);
+    return getErrorCount() == 0 ? 0 : 1;
+}
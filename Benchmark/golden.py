@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+from run_benchmarks import BENCHMARK_DIR, REPO_DIR, build_program, compile_library
+
+
+def find_baseline():
+    """
+    Revision that added golden renders, its DSP code is the reference for
+    every later change
+    """
+    result = subprocess.run(
+        ['git', 'log', '--diff-filter=A', '--format=%H', '--', 'Benchmark/GoldenRender.cpp'],
+        cwd=REPO_DIR, capture_output=True, text=True, check=True)
+    return result.stdout.split()[-1]
+
+
+def checkout(revision, build_dir):
+    worktree = os.path.join(build_dir, 'baseline')
+    if os.path.exists(worktree):
+        subprocess.run(['git', 'worktree', 'remove', '--force', worktree], cwd=REPO_DIR)
+        shutil.rmtree(worktree, ignore_errors=True)
+    subprocess.run(['git', 'worktree', 'add', '--detach', worktree, revision], cwd=REPO_DIR, check=True)
+    return worktree
+
+
+def main(args):
+    build_dir = os.path.abspath(args.build_dir)
+    os.makedirs(build_dir, exist_ok=True)
+    os.makedirs(args.reference, exist_ok=True)
+    library = compile_library(args, build_dir)
+    repo_dir = REPO_DIR
+    if args.baseline is not None:
+        if args.mode != 'render':
+            print('--baseline is only used for rendering references', file=sys.stderr)
+            return 2
+        revision = args.baseline or find_baseline()
+        print(f'Rendering references from {revision}', file=sys.stderr)
+        repo_dir = checkout(revision, build_dir)
+    binary = os.path.join(build_dir, 'GoldenRender')
+    result = build_program(args, library, 'GoldenRender.cpp', binary, repo_dir=repo_dir)
+    if repo_dir != REPO_DIR:
+        subprocess.run(['git', 'worktree', 'remove', '--force', repo_dir], cwd=REPO_DIR)
+    if result.returncode != 0:
+        print(result.stderr, file=sys.stderr)
+        return result.returncode
+    command = [binary, args.mode, args.reference]
+    if args.mode == 'compare':
+        command += ['-e', str(args.max_error), '-d', str(args.max_distance)]
+    return subprocess.run(command + args.cases).returncode
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Render or compare golden outputs for DSP classes")
+    parser.add_argument('mode', choices=['render', 'compare'], help='Store new references or compare against them')
+    parser.add_argument('-o', '--owl', help='Path to OwlProgram', default=os.path.join(REPO_DIR, '..', 'OwlProgram'))
+    parser.add_argument('-d', '--daisysp', help='Path to DaisySP')
+    parser.add_argument('-r', '--reference', help='Reference directory', default=os.path.join(BENCHMARK_DIR, 'reference'))
+    parser.add_argument('-b', '--build_dir', help='Build directory', default=os.path.join(BENCHMARK_DIR, 'build'))
+    parser.add_argument('-g', '--baseline', nargs='?', const='',
+                        help='Render references with DSP code from git revision '
+                        '(revision that added golden renders by default)')
+    parser.add_argument('-e', '--max_error', help='Max absolute sample error', type=float, default=1e-5)
+    parser.add_argument('-s', '--max_distance', help='Max log-spectral distance in dB', type=float, default=0.5)
+    parser.add_argument('-c', '--cxx', help='C++ compiler', default='g++')
+    parser.add_argument('-f', '--cflags', help='Extra compiler flags', nargs='*', default=[])
+    parser.add_argument('--rebuild', help='Rebuild OwlProgram library', action='store_true')
+    parser.add_argument('cases', nargs='*', help='Cases to render or compare (all by default)')
+
+    args = parser.parse_args()
+    sys.exit(main(args))
@@ -0,0 +1,22 @@
+#ifndef __ColourScreenPatch_h__
+#define __ColourScreenPatch_h__
+
+#include "Patch.h"
+#include "HostScreenBuffer.h"
+
+typedef HostScreenBuffer<320, 240> ColourScreenBuffer;
+
+class ColourScreenPatch : public Patch {
+public:
+    ColourScreenPatch() = default;
+    virtual ~ColourScreenPatch() = default;
+    uint16_t getScreenWidth() {
+        return 320;
+    }
+    uint16_t getScreenHeight() {
+        return 240;
+    }
+    virtual void processScreen(ColourScreenBuffer& screen) = 0;
+};
+
+#endif // __ColourScreenPatch_h__
@@ -0,0 +1,36 @@
+#include <cstdio>
+#include "message.h"
+
+static int error_count = 0;
+
+extern "C" {
+void debugMessage(const char* msg) {
+    fprintf(stderr, "%s\n", msg);
+}
+void error(int8_t code, const char* reason) {
+    fprintf(stderr, "Error 0x%x: %s\n", code, reason);
+    error_count++;
+}
+int getErrorCount() {
+    return error_count;
+}
+}
+
+void debugMessage(const char* msg, int a) {
+    fprintf(stderr, "%s %d\n", msg, a);
+}
+void debugMessage(const char* msg, int a, int b) {
+    fprintf(stderr, "%s %d %d\n", msg, a, b);
+}
+void debugMessage(const char* msg, int a, int b, int c) {
+    fprintf(stderr, "%s %d %d %d\n", msg, a, b, c);
+}
+void debugMessage(const char* msg, float a) {
+    fprintf(stderr, "%s %f\n", msg, a);
+}
+void debugMessage(const char* msg, float a, float b) {
+    fprintf(stderr, "%s %f %f\n", msg, a, b);
+}
+void debugMessage(const char* msg, float a, float b, float c) {
+    fprintf(stderr, "%s %f %f %f\n", msg, a, b, c);
+}
@@ -0,0 +1,70 @@
+#ifndef __HostScreenBuffer_h__
+#define __HostScreenBuffer_h__
+
+/**
+ * Minimal screen buffer for host builds. Drawing calls are accepted, but
+ * nothing is rendered - harness only measures audio processing cost.
+ */
+
+#include <cstdint>
+
+typedef uint16_t Colour;
+
+enum {
+    BLACK = 0x0000,
+    BLUE = 0x001F,
+    RED = 0xF800,
+    GREEN = 0x07E0,
+    CYAN = 0x07FF,
+    MAGENTA = 0xF81F,
+    YELLOW = 0xFFE0,
+    WHITE = 0xFFFF
+};
+
+template <uint16_t width, uint16_t height>
+class HostScreenBuffer {
+public:
+    uint16_t getWidth() const {
+        return width;
+    }
+    uint16_t getHeight() const {
+        return height;
+    }
+    void clear() {
+    }
+    void setPixel(uint16_t x, uint16_t y, Colour c) {
+    }
+    Colour getPixel(uint16_t x, uint16_t y) {
+        return BLACK;
+    }
+    void setCursor(uint16_t x, uint16_t y) {
+    }
+    void setTextSize(uint8_t size) {
+    }
+    void setTextColour(Colour colour) {
+    }
+    void print(const char* str) {
+    }
+    void print(int num) {
+    }
+    void print(float num) {
+    }
+    void print(uint16_t x, uint16_t y, const char* str) {
+    }
+    void drawHorizontalLine(uint16_t x, uint16_t y, uint16_t length, Colour c) {
+    }
+    void drawVerticalLine(uint16_t x, uint16_t y, uint16_t length, Colour c) {
+    }
+    void drawLine(int x0, int y0, int x1, int y1, Colour c) {
+    }
+    void drawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Colour c) {
+    }
+    void fillRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Colour c) {
+    }
+    void drawCircle(uint16_t x, uint16_t y, uint16_t r, Colour c) {
+    }
+    void fillCircle(uint16_t x, uint16_t y, uint16_t r, Colour c) {
+    }
+};
+
+#endif // __HostScreenBuffer_h__
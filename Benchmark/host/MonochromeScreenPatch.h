@@ -0,0 +1,22 @@
+#ifndef __MonochromeScreenPatch_h__
+#define __MonochromeScreenPatch_h__
+
+#include "Patch.h"
+#include "HostScreenBuffer.h"
+
+typedef HostScreenBuffer<128, 64> MonochromeScreenBuffer;
+
+class MonochromeScreenPatch : public Patch {
+public:
+    MonochromeScreenPatch() = default;
+    virtual ~MonochromeScreenPatch() = default;
+    uint16_t getScreenWidth() {
+        return 128;
+    }
+    uint16_t getScreenHeight() {
+        return 64;
+    }
+    virtual void processScreen(MonochromeScreenBuffer& screen) = 0;
+};
+
+#endif // __MonochromeScreenPatch_h__
@@ -0,0 +1,242 @@
+#ifndef __Patch_h__
+#define __Patch_h__
+
+/**
+ * Host stand-in for OpenWare Patch API.
+ *
+ * This header shadows Patch.h from OwlProgram when building patches for
+ * benchmarking on a desktop machine. Everything else (FloatArray, oscillators,
+ * filters, etc) comes from OwlProgram's LibSource compiled natively, only the
+ * parts that would talk to firmware are replaced here.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "basicmaths.h"
+#include "FloatArray.h"
+#include "MidiMessage.h"
+#include "OpenWareMidiControl.h"
+#include "Resource.h"
+#include "message.h"
+
+enum PatchParameterId {
+    PARAMETER_A,
+    PARAMETER_B,
+    PARAMETER_C,
+    PARAMETER_D,
+    PARAMETER_E,
+    PARAMETER_F,
+    PARAMETER_G,
+    PARAMETER_H,
+    PARAMETER_AA,
+    PARAMETER_AB,
+    PARAMETER_AC,
+    PARAMETER_AD,
+    PARAMETER_AE,
+    PARAMETER_AF,
+    PARAMETER_AG,
+    PARAMETER_AH,
+    PARAMETER_BA,
+    PARAMETER_BB,
+    PARAMETER_BC,
+    PARAMETER_BD,
+    PARAMETER_BE,
+    PARAMETER_BF,
+    PARAMETER_BG,
+    PARAMETER_BH,
+    PARAMETER_CA,
+    PARAMETER_CB,
+    PARAMETER_CC,
+    PARAMETER_CD,
+    PARAMETER_CE,
+    PARAMETER_CF,
+    PARAMETER_CG,
+    PARAMETER_CH,
+    PARAMETER_DA,
+    PARAMETER_DB,
+    PARAMETER_DC,
+    PARAMETER_DD,
+    PARAMETER_DE,
+    PARAMETER_DF,
+    PARAMETER_DG,
+    PARAMETER_DH,
+    NOF_PARAMETERS
+};
+
+enum PatchButtonId {
+    BYPASS_BUTTON = 0,
+    PUSHBUTTON,
+    GREEN_BUTTON,
+    RED_BUTTON,
+    BUTTON_A,
+    BUTTON_B,
+    BUTTON_C,
+    BUTTON_D,
+    BUTTON_E,
+    BUTTON_F,
+    BUTTON_G,
+    BUTTON_H,
+    BUTTON_1 = BUTTON_A,
+    BUTTON_2,
+    BUTTON_3,
+    BUTTON_4,
+    BUTTON_5,
+    BUTTON_6,
+    BUTTON_7,
+    BUTTON_8,
+    NOF_BUTTONS = 16,
+    MIDI_NOTE_BUTTON = 0x80
+};
+
+enum PatchChannelId {
+    LEFT_CHANNEL = 0,
+    RIGHT_CHANNEL = 1
+};
+
+class AudioBuffer {
+public:
+    virtual ~AudioBuffer() = default;
+    virtual FloatArray getSamples(int channel) = 0;
+    virtual int getChannels() = 0;
+    virtual int getSize() = 0;
+    virtual void clear() = 0;
+
+    void multiply(float gain) {
+        for (int ch = 0; ch < getChannels(); ch++)
+            getSamples(ch).multiply(gain);
+    }
+    void add(AudioBuffer& other) {
+        for (int ch = 0; ch < getChannels(); ch++)
+            getSamples(ch).add(other.getSamples(ch));
+    }
+    void copyFrom(AudioBuffer& other) {
+        for (int ch = 0; ch < getChannels(); ch++)
+            getSamples(ch).copyFrom(other.getSamples(ch));
+    }
+    void copyTo(AudioBuffer& other) {
+        other.copyFrom(*this);
+    }
+
+    static AudioBuffer* create(int channels, int samples);
+    static void destroy(AudioBuffer* buffer) {
+        delete buffer;
+    }
+};
+
+/**
+ * Audio buffer with channels stored in a single contiguous allocation
+ */
+class HostAudioBuffer : public AudioBuffer {
+public:
+    HostAudioBuffer(int channels, int size)
+        : channels(channels)
+        , size(size)
+        , data(new float[channels * size]()) {
+    }
+    ~HostAudioBuffer() {
+        delete[] data;
+    }
+    FloatArray getSamples(int channel) override {
+        return FloatArray(data + channel * size, size);
+    }
+    int getChannels() override {
+        return channels;
+    }
+    int getSize() override {
+        return size;
+    }
+    void clear() override {
+        std::fill(data, data + channels * size, 0.0f);
+    }
+
+private:
+    int channels;
+    int size;
+    float* data;
+};
+
+/**
+ * Parameters, buttons and audio settings shared between the harness and
+ * the patch under test. Must be configured before a patch is constructed,
+ * because patches query sample rate and block size from their constructors.
+ */
+class HostPatchContext {
+public:
+    static HostPatchContext& get() {
+        static HostPatchContext context;
+        return context;
+    }
+    float sample_rate = 48000;
+    int block_size = 64;
+    int channels = 2;
+    float parameters[NOF_PARAMETERS] = {};
+    bool buttons[NOF_BUTTONS] = {};
+    const char* parameter_names[NOF_PARAMETERS] = {};
+    uint32_t elapsed_cycles = 0;
+};
+
+class Patch {
+public:
+    Patch() = default;
+    virtual ~Patch() = default;
+
+    void registerParameter(PatchParameterId pid, const char* name) {
+        HostPatchContext::get().parameter_names[pid] = name;
+    }
+    float getParameterValue(PatchParameterId pid) {
+        return HostPatchContext::get().parameters[pid];
+    }
+    void setParameterValue(PatchParameterId pid, float value) {
+        HostPatchContext::get().parameters[pid] = value;
+    }
+    bool isButtonPressed(PatchButtonId bid) {
+        return bid < NOF_BUTTONS && HostPatchContext::get().buttons[bid];
+    }
+    void setButton(PatchButtonId bid, uint16_t value, uint16_t samples = 0) {
+        if (bid < NOF_BUTTONS)
+            HostPatchContext::get().buttons[bid] = value != 0;
+    }
+    void sendMidi(MidiMessage msg) {
+    }
+    int getBlockSize() {
+        return HostPatchContext::get().block_size;
+    }
+    float getSampleRate() {
+        return HostPatchContext::get().sample_rate;
+    }
+    float getBlockRate() {
+        return getSampleRate() / getBlockSize();
+    }
+    int getNumberOfChannels() {
+        return HostPatchContext::get().channels;
+    }
+    float getElapsedBlockTime() {
+        return 0.0f;
+    }
+    int getElapsedCycles() {
+        return HostPatchContext::get().elapsed_cycles;
+    }
+    AudioBuffer* createMemoryBuffer(int channels, int samples) {
+        return AudioBuffer::create(channels, samples);
+    }
+    Resource* getResource(const char* name) {
+        Resource* resource = Resource::load(name);
+        if (resource == NULL)
+            error(CONFIGURATION_ERROR_STATUS, "Missing Resource");
+        return resource;
+    }
+
+    virtual void buttonChanged(PatchButtonId bid, uint16_t value, uint16_t samples) {
+    }
+    virtual void encoderChanged(PatchParameterId pid, int16_t delta, uint16_t samples) {
+    }
+    virtual void processMidi(MidiMessage msg) {
+    }
+    virtual void processAudio(AudioBuffer& audio) = 0;
+};
+
+inline AudioBuffer* AudioBuffer::create(int channels, int samples) {
+    return new HostAudioBuffer(channels, samples);
+}
+
+#endif // __Patch_h__
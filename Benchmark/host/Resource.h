@@ -0,0 +1,160 @@
+#ifndef __Resource_h__
+#define __Resource_h__
+
+/**
+ * Host stand-in for OpenWare resources.
+ *
+ * Resources are read from files in directory given by OWL_RESOURCE_PATH
+ * environment variable (current directory by default). If file with exact
+ * resource name is not found, we also try files with the same base name and
+ * .wav or .bin extension, i.e. "wavetable1.wav" resolves to wavetable1.bin
+ * that is stored in this repo. Resource header produced by makeresource.py
+ * is skipped for WAV data and precomputed WaveBank data.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+class Resource {
+public:
+    Resource() = default;
+
+    const char* getName() const {
+        return name.c_str();
+    }
+    size_t getSize() const {
+        return size;
+    }
+    bool hasData() const {
+        return data != NULL;
+    }
+    const uint8_t* getData() const {
+        return data;
+    }
+    uint8_t* getData() {
+        return data;
+    }
+    /**
+     * Host resources are always copied to RAM, so they're never memory mapped.
+     */
+    bool isMemoryMapped() const {
+        return false;
+    }
+
+    template <typename Array, typename Element>
+    Array asArray(size_t offset = 0, size_t max_size = SIZE_MAX) const {
+        size_t count = (size - offset) / sizeof(Element);
+        if (count > max_size)
+            count = max_size;
+        return Array((Element*)(data + offset), count);
+    }
+
+    /**
+     * Read part of resource data to caller provided buffer
+     * @return number of bytes read
+     */
+    size_t read(void* dst, size_t len, size_t offset = 0) const {
+        if (offset >= size)
+            return 0;
+        if (len > size - offset)
+            len = size - offset;
+        memcpy(dst, data + offset, len);
+        return len;
+    }
+
+    static Resource* open(const char* name) {
+        return load(name);
+    }
+
+    static Resource* load(const char* name) {
+        std::string path = findPath(name);
+        if (path.empty())
+            return NULL;
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+            return NULL;
+        fseek(file, 0, SEEK_END);
+        long file_size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        uint8_t* buffer = new uint8_t[file_size];
+        size_t loaded = fread(buffer, 1, file_size, file);
+        fclose(file);
+        Resource* resource = new Resource();
+        resource->name = name;
+        resource->allocated = buffer;
+        resource->data = buffer;
+        resource->size = loaded;
+        resource->skipHeader();
+        return resource;
+    }
+
+    static const Resource* get(const char* name) {
+        return load(name);
+    }
+
+    static void destroy(Resource* resource) {
+        if (resource != NULL) {
+            delete[] resource->allocated;
+            delete resource;
+        }
+    }
+
+    static void destroy(const Resource* resource) {
+        destroy(const_cast<Resource*>(resource));
+    }
+
+private:
+    std::string name;
+    uint8_t* allocated = NULL;
+    uint8_t* data = NULL;
+    size_t size = 0;
+    static constexpr size_t max_header_size = 64;
+
+    void skipHeader() {
+        for (const char* magic : { "RIFF", "WBNK" }) {
+            if (size < 4 || memcmp(data, magic, 4) == 0)
+                return;
+        }
+        for (size_t i = 1; i + 4 <= size && i < max_header_size; i++) {
+            for (const char* magic : { "RIFF", "WBNK" }) {
+                if (memcmp(data + i, magic, 4) == 0) {
+                    data += i;
+                    size -= i;
+                    return;
+                }
+            }
+        }
+    }
+
+    static bool exists(const std::string& path) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+            return false;
+        fclose(file);
+        return true;
+    }
+
+    static std::string findPath(const char* name) {
+        const char* dir = getenv("OWL_RESOURCE_PATH");
+        std::string prefix = dir == NULL ? std::string("./") : std::string(dir) + "/";
+        std::string path = prefix + name;
+        if (exists(path))
+            return path;
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of('/');
+        std::string base = path;
+        if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+            base = path.substr(0, dot);
+        for (const char* ext : { ".wav", ".bin" }) {
+            if (exists(base + ext))
+                return base + ext;
+        }
+        return std::string();
+    }
+};
+
+#endif // __Resource_h__
@@ -0,0 +1,49 @@
+#ifndef __MESSAGE_H
+#define __MESSAGE_H
+
+/**
+ * Host stand-in for OwlProgram message functions. Messages are printed to
+ * stderr, errors are counted so that the harness can flag a patch that
+ * failed to initialise instead of reporting bogus timings for it.
+ */
+
+#include <cstdint>
+
+#ifndef CONFIGURATION_ERROR_STATUS
+#define NO_ERROR 0x00
+#define HARDFAULT_ERROR_STATUS 0x10
+#define BUS_ERROR_STATUS 0x20
+#define MEM_ERROR_STATUS 0x30
+#define NMI_ERROR_STATUS 0x40
+#define USAGE_ERROR_STATUS 0x50
+#define PROGRAM_ERROR_STATUS 0x60
+#define CONFIGURATION_ERROR_STATUS 0x70
+#define OUT_OF_MEMORY_ERROR_STATUS 0x80
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void debugMessage(const char* msg);
+void error(int8_t code, const char* reason);
+int getErrorCount();
+
+#ifdef __cplusplus
+}
+
+void debugMessage(const char* msg, int);
+void debugMessage(const char* msg, int, int);
+void debugMessage(const char* msg, int, int, int);
+void debugMessage(const char* msg, float);
+void debugMessage(const char* msg, float, float);
+void debugMessage(const char* msg, float, float, float);
+#endif
+
+#define ASSERT(cond, msg) \
+    do {                  \
+        if (!(cond))      \
+            error(PROGRAM_ERROR_STATUS, msg); \
+    } while (0)
+
+#endif /* __MESSAGE_H */
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+
+import argparse
+import glob
+import json
+import os
+import subprocess
+import sys
+
+
+REPO_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BENCHMARK_DIR = os.path.join(REPO_DIR, 'Benchmark')
+PATCH_DIRS = ['C++', 'CloudSeed', 'DaisySP', 'Wavetables', 'Resources']
+INCLUDE_DIRS = ['C++', 'CloudSeed', 'Wavetables', 'DaisySP', 'KastleDrum']
+# These are replaced by stand-ins from Benchmark/host
+EXCLUDED_SOURCES = [
+    'Patch.cpp', 'Resource.cpp', 'MonochromeScreenPatch.cpp', 'ColourScreenPatch.cpp',
+    'ScreenBuffer.cpp', 'message.cpp']
+
+
+def find_patches(names):
+    patches = []
+    for directory in PATCH_DIRS:
+        for path in sorted(glob.glob(os.path.join(REPO_DIR, directory, '*Patch.hpp'))):
+            name = os.path.basename(path)[:-len('.hpp')]
+            if not names or name in names:
+                patches.append((name, path))
+    return patches
+
+
+def compile_library(args, build_dir):
+    """
+    Compile OwlProgram LibSource (and DaisySP if available) once, patches link
+    against resulting archive
+    """
+    library = os.path.join(build_dir, 'libowl.a')
+    if os.path.exists(library) and not args.rebuild:
+        return library
+    objects = []
+    sources = glob.glob(os.path.join(args.owl, 'LibSource', '*.c*'))
+    if args.daisysp:
+        sources += glob.glob(os.path.join(args.daisysp, 'Source', '**', '*.cpp'), recursive=True)
+    for source in sorted(sources):
+        if os.path.basename(source) in EXCLUDED_SOURCES:
+            continue
+        obj = os.path.join(build_dir, os.path.basename(source) + '.o')
+        # Third party library code, its warnings are not ours to fix
+        subprocess.run(
+            [args.cxx] + cflags(args) + ['-w', '-c', source, '-o', obj], check=True)
+        objects.append(obj)
+    subprocess.run(['ar', 'rcs', library] + objects, check=True)
+    return library
+
+
+def cflags(args, repo_dir=REPO_DIR):
+    flags = ['-O2', '-std=gnu++17', '-Wall']
+    flags += ['-I' + os.path.join(repo_dir, 'Benchmark', 'host')]
+    flags += ['-I' + os.path.join(repo_dir, directory) for directory in INCLUDE_DIRS]
+    # OwlProgram and DaisySP headers are system includes, so only warnings
+    # from this repo are reported
+    flags += ['-isystem' + os.path.join(args.owl, directory) for directory in ('LibSource', 'Source')]
+    if args.daisysp:
+        flags += ['-isystem' + os.path.join(args.daisysp, 'Source')]
+    flags += args.cflags
+    return flags
+
+
+def build_program(args, library, source, binary, flags=[], repo_dir=REPO_DIR):
+    benchmark_dir = os.path.join(repo_dir, 'Benchmark')
+    return subprocess.run(
+        [args.cxx] + cflags(args, repo_dir) + flags + [
+            os.path.join(benchmark_dir, source), os.path.join(benchmark_dir, 'host', 'HostMessage.cpp'),
+            library, '-lm', '-o', binary],
+        capture_output=True, text=True)
+
+
+def build_patch(args, build_dir, library, name, path):
+    binary = os.path.join(build_dir, name)
+    result = build_program(args, library, 'PatchBenchmark.cpp', binary, [
+        '-I' + os.path.dirname(path),
+        f'-DPATCH_HEADER="{os.path.basename(path)}"', f'-DPATCH_CLASS={name}'])
+    if result.returncode != 0:
+        return None, result.stderr
+    return binary, result.stderr
+
+
+def run_patch(args, binary, sample_rate, block_size):
+    env = dict(os.environ, OWL_RESOURCE_PATH=args.resources)
+    result = subprocess.run(
+        [binary, '-sr', str(sample_rate), '-bs', str(block_size),
+            '-n', str(args.blocks), '-w', str(args.warmup)],
+        capture_output=True, text=True, env=env)
+    try:
+        return json.loads(result.stdout), result.stderr
+    except json.JSONDecodeError:
+        return None, result.stderr
+
+
+def main(args):
+    build_dir = os.path.abspath(args.build_dir)
+    os.makedirs(build_dir, exist_ok=True)
+    library = compile_library(args, build_dir)
+    results = []
+    for name, path in find_patches(args.patches):
+        binary, log = build_patch(args, build_dir, library, name, path)
+        if binary is None:
+            print(f'{name} => build failed', file=sys.stderr)
+            results.append({'patch': name, 'error': 'build failed', 'log': log})
+            continue
+        warnings = log.count('warning:')
+        if warnings:
+            print(f'{name} => {warnings} compiler warnings', file=sys.stderr)
+        for sample_rate in args.sample_rates:
+            for block_size in args.block_sizes:
+                result, errors = run_patch(args, binary, sample_rate, block_size)
+                if result is None:
+                    print(f'{name} => run failed', file=sys.stderr)
+                    results.append({
+                        'patch': name, 'sample_rate': sample_rate, 'block_size': block_size,
+                        'error': 'run failed', 'log': errors})
+                else:
+                    print(f'{name} @ {sample_rate}Hz/{block_size} => '
+                          f'{result["ns_per_sample"]:.1f} ns/sample, '
+                          f'{result["budget_percent"]:.1f}%', file=sys.stderr)
+                    if warnings:
+                        result['warnings'] = warnings
+                        result['build_log'] = log
+                    results.append(result)
+
+    output = json.dumps({'results': results}, indent=2)
+    if args.output:
+        with open(args.output, 'w') as fobj:
+            fobj.write(output)
+    else:
+        print(output)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Benchmark patches on host and report CPU load as JSON")
+    parser.add_argument('-o', '--owl', help='Path to OwlProgram', default=os.path.join(REPO_DIR, '..', 'OwlProgram'))
+    parser.add_argument('-d', '--daisysp', help='Path to DaisySP (needed for DaisySP patches)')
+    parser.add_argument('-r', '--resources', help='Directory with resources', default=os.path.join(REPO_DIR, 'Wavetables'))
+    parser.add_argument('-b', '--build_dir', help='Build directory', default=os.path.join(BENCHMARK_DIR, 'build'))
+    parser.add_argument('-sr', '--sample_rates', help='Sample rates', type=float, nargs='+', default=[48000])
+    parser.add_argument('-bs', '--block_sizes', help='Block sizes', type=int, nargs='+', default=[64])
+    parser.add_argument('-n', '--blocks', help='Number of blocks to process', type=int, default=10000)
+    parser.add_argument('-w', '--warmup', help='Number of blocks to process before measuring', type=int, default=100)
+    parser.add_argument('-c', '--cxx', help='C++ compiler', default='g++')
+    parser.add_argument('-f', '--cflags', help='Extra compiler flags', nargs='*', default=[])
+    parser.add_argument('--output', help='Write JSON results to file instead of stdout')
+    parser.add_argument('--rebuild', help='Rebuild OwlProgram library', action='store_true')
+    parser.add_argument('patches', nargs='*', help='Patch names to benchmark (all by default)')
+
+    args = parser.parse_args()
+    main(args)
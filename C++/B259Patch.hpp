@@ -0,0 +1,58 @@
+#ifndef __B259_PATCH_HPP__
+#define __B259_PATCH_HPP__
+
+/**
+ * Buchla 259 style stereo wavefolder, native replacement for Faust/B259.dsp
+ *
+ * - param A sets amount of folding
+ * - param B adds offset to folder input
+ * - param C sets lowpass filter cutoff after folder
+ **/
+
+#include "Patch.h"
+#include "B259Wavefolder.hpp"
+
+//#define OVERSAMPLE_FACTOR 2
+
+#ifdef OVERSAMPLE_FACTOR
+#include "Oversampled.hpp"
+using StereoB259 = Oversampled<B259Wavefolder<2>, OVERSAMPLE_FACTOR, 2>;
+#else
+using StereoB259 = B259Wavefolder<2>;
+#endif
+
+#define P_FOLD PARAMETER_A
+#define P_OFFSET PARAMETER_B
+#define P_LOWPASS PARAMETER_C
+
+class B259Patch : public Patch {
+private:
+    StereoB259* wavefolder;
+
+public:
+    B259Patch() {
+        registerParameter(P_FOLD, "Fold");
+        registerParameter(P_OFFSET, "Offset");
+        setParameterValue(P_OFFSET, 0.5);
+        registerParameter(P_LOWPASS, "Lowpass");
+#ifdef OVERSAMPLE_FACTOR
+        wavefolder = StereoB259::create(
+            getBlockSize(), getSampleRate() * OVERSAMPLE_FACTOR);
+#else
+        wavefolder = StereoB259::create(getSampleRate());
+#endif
+    }
+
+    ~B259Patch() {
+        StereoB259::destroy(wavefolder);
+    }
+
+    void processAudio(AudioBuffer& buffer) override {
+        wavefolder->setFold(getParameterValue(P_FOLD));
+        wavefolder->setOffset(getParameterValue(P_OFFSET) * 2 - 1);
+        wavefolder->setLowpass(getParameterValue(P_LOWPASS));
+        wavefolder->process(buffer, buffer);
+    }
+};
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef __B259_WAVEFOLDER_HPP__
+#define __B259_WAVEFOLDER_HPP__
+
+#include "SignalProcessor.h"
+#include "Nonlinearity.hpp"
+
+// Source: https://github.com/yorgoszachos/b259wf
+
+/**
+ * Single stage of Buchla 259 folder, built from its resistor values in
+ * kOhm and output gain.
+ */
+struct B259Stage {
+    float threshold;
+    float gain;
+
+    static constexpr float supply = 6;
+    static constexpr float r2 = 100;
+
+    constexpr B259Stage(float r1, float r3, float c)
+        : threshold(supply * r1 / r2)
+        , gain(r2 * r3 / (r1 * r3 + r2 * r3 + r1 * r2) * c) {
+    }
+};
+
+/**
+ * Folding function of Buchla 259 timbre circuit: 5 parallel stages that
+ * pass signal only above their threshold, summed with the input. Input is
+ * in volts.
+ *
+ * Every stage is piecewise linear, so antiderivatives are exact.
+ */
+class B259FoldFunction : public Nonlinearity {
+public:
+    static constexpr size_t num_stages = 5;
+    static constexpr B259Stage stages[num_stages] = {
+        { 10, 100, -12 },
+        { 49.9, 43.2, -27.777 },
+        { 91, 56, -21.428 },
+        { 30, 68, 17.647 },
+        { 68, 33, 36.363 },
+    };
+
+    static float getSample(float x) {
+        float a = std::abs(x);
+        float acc = 0;
+        for (size_t i = 0; i < num_stages; i++) {
+            float d = a > stages[i].threshold ? a - stages[i].threshold : 0;
+            acc += stages[i].gain * d;
+        }
+        return 5 * x + sign(x) * acc;
+    }
+    static float getAntiderivative1(float x) {
+        float a = std::abs(x);
+        float acc = 0;
+        for (size_t i = 0; i < num_stages; i++) {
+            float d = a > stages[i].threshold ? a - stages[i].threshold : 0;
+            acc += stages[i].gain * d * d;
+        }
+        return 2.5f * x * x + 0.5f * acc;
+    }
+    static float getAntiderivative2(float x) {
+        float a = std::abs(x);
+        float acc = 0;
+        for (size_t i = 0; i < num_stages; i++) {
+            float d = a > stages[i].threshold ? a - stages[i].threshold : 0;
+            acc += stages[i].gain * d * d * d;
+        }
+        return (5 * x * x * x + sign(x) * acc) / 6;
+    }
+};
+
+/**
+ * Buchla 259 style wavefolder, native version of Faust/B259.dsp.
+ *
+ * All channels are processed together in a single loop with first order
+ * antiderivative antialiasing instead of per stage lowpass filters. Folding
+ * is followed by a lowpass filter, cubic soft clipper and DC blocker.
+ *
+ * Higher order antialiasing is not used, as its antiderivative grows too
+ * large for float precision at high fold amounts. For stronger alias
+ * suppression wrap this class in Oversampled and pass it oversampled rate.
+ */
+template <size_t num_channels = 2>
+class B259Wavefolder : public MultiSignalProcessor {
+public:
+    B259Wavefolder(float sr)
+        : sample_rate(sr)
+        , dc_coeff(1 - 2 * M_PI * 10 / sr)
+        , gain(threshold)
+        , gain_target(threshold)
+        , offset(0)
+        , offset_target(0)
+        , lowpass(0) {
+        setLowpass(0);
+        reset();
+    }
+
+    /**
+     * Amount of folding in [0..1] range
+     */
+    void setFold(float fold) {
+        gain_target = threshold * (1 + fold * 19);
+    }
+
+    /**
+     * Offset in [-1..1] range, shifts folding towards one side
+     */
+    void setOffset(float offset) {
+        offset_target = offset * B259FoldFunction::stages[2].threshold;
+    }
+
+    /**
+     * Lowpass cutoff in [0..1] range, mapped from 1300Hz to a bit below
+     * Nyquist with square law
+     */
+    void setLowpass(float value) {
+        float max_cutoff = sample_rate / 2.6f;
+        float cutoff = 1300 + (max_cutoff - 1300) * value * value;
+        lowpass = 1 - expf(-2 * M_PI * cutoff / sample_rate);
+    }
+
+    /**
+     * Fold and offset are ramped over the block
+     */
+    void process(AudioBuffer& input, AudioBuffer& output) {
+        size_t size = input.getSize();
+        float* in[num_channels];
+        float* out[num_channels];
+        for (size_t ch = 0; ch < num_channels; ch++) {
+            in[ch] = input.getSamples(ch).getData();
+            out[ch] = output.getSamples(ch).getData();
+        }
+        const float gain_step = (gain_target - gain) / size;
+        const float offset_step = (offset_target - offset) / size;
+        const float klp = lowpass;
+        for (size_t n = 0; n < size; n++) {
+            gain += gain_step;
+            offset += offset_step;
+            for (size_t ch = 0; ch < num_channels; ch++) {
+                float x = in[ch][n] * gain + offset;
+                float dx = x - xn1[ch];
+                float F = B259FoldFunction::getAntiderivative1(x);
+                bool ill = std::abs(dx) < thresh;
+                float fallback = B259FoldFunction::getSample(0.5f * (x + xn1[ch]));
+                float folded = ill ? fallback : (F - Fn1[ch]) / (ill ? 1.0f : dx);
+                xn1[ch] = x;
+                Fn1[ch] = F;
+
+                lp_state[ch] += klp * (folded - lp_state[ch]);
+                // Classic cubic softclip scaled to [-2/3..2/3]
+                float y = CubicSaturator::getSample(lp_state[ch] / 6) * (2.f / 3);
+                float dc = y - dc_x[ch] + dc_coeff * dc_y[ch];
+                dc_x[ch] = y;
+                dc_y[ch] = dc;
+                out[ch][n] = dc;
+            }
+        }
+        gain = gain_target;
+        offset = offset_target;
+    }
+
+    void reset() {
+        for (size_t ch = 0; ch < num_channels; ch++) {
+            xn1[ch] = 0;
+            Fn1[ch] = 0;
+            lp_state[ch] = 0;
+            dc_x[ch] = 0;
+            dc_y[ch] = 0;
+        }
+    }
+
+    static B259Wavefolder* create(float sr) {
+        return new B259Wavefolder(sr);
+    }
+
+    static void destroy(B259Wavefolder* wavefolder) {
+        delete wavefolder;
+    }
+
+protected:
+    // Input is scaled to volts, unity fold reaches the first threshold
+    static constexpr float threshold = B259FoldFunction::stages[0].threshold;
+    static constexpr float thresh = 10.0e-2;
+    float sample_rate;
+    float dc_coeff;
+    float gain, gain_target;
+    float offset, offset_target;
+    float lowpass;
+    float xn1[num_channels];
+    float Fn1[num_channels];
+    float lp_state[num_channels];
+    float dc_x[num_channels];
+    float dc_y[num_channels];
+};
+
+#endif
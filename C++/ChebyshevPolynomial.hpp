@@ -290,4 +290,205 @@ protected:
     using Base::polynomials;
 };
 
+/**
+ * Weighted sum of Chebyshev polynomials c0 * P0(x) + c1 * P1(x) + ... +
+ * cN * PN(x), evaluated with Clenshaw's algorithm.
+ *
+ * All four kinds share the recurrence Pn(x) = 2 * x * Pn-1(x) - Pn-2(x), so
+ * a single backward pass over coefficients costs one multiply-add pair per
+ * order regardless of which polynomials are summed. Coefficients set between
+ * blocks are crossfaded over the next processed block. This is done by
+ * running a second recurrence on coefficient deltas in the same pass, which
+ * is skipped when coefficients didn't change.
+ */
+template <size_t max_order, class Base>
+class ChebyshevSeriesTemplate : public Base {
+public:
+    void setCoefficient(size_t order, float coefficient) {
+        coefficients[order] = coefficient;
+    }
+    float getCoefficient(size_t order) const {
+        return coefficients[order];
+    }
+    /**
+     * Scale coefficients so that sum of their absolute values is 1
+     */
+    void normalize() {
+        float _gain = 0.f;
+        for (size_t i = 0; i < max_order + 1; i++) {
+            _gain += std::abs(coefficients[i]);
+        }
+        if (_gain > 0)
+            _gain = 1.f / _gain;
+        gain = _gain;
+        for (size_t i = 0; i < max_order + 1; i++) {
+            coefficients[i] *= gain;
+        }
+    }
+    float getGain() const {
+        return gain;
+    }
+
+protected:
+    float coefficients[max_order + 1] {};
+    float previous[max_order + 1] {};
+    float deltas[max_order + 1] {};
+    float gain = 1.f;
+
+    /**
+     * Prepare per block coefficient deltas, returns false if there's
+     * nothing to crossfade
+     */
+    bool prepare() {
+        bool changed = false;
+        for (size_t i = 0; i < max_order + 1; i++) {
+            deltas[i] = coefficients[i] - previous[i];
+            changed |= deltas[i] != 0.f;
+        }
+        return changed;
+    }
+
+    void finish() {
+        memcpy(previous, coefficients, sizeof(previous));
+    }
+
+    /**
+     * Backward recurrence bk = ck + 2 * x * bk+1 - bk+2 down to b1, with
+     * coefficients crossfaded by t. Returns c0, b1 and b2.
+     */
+    template <bool crossfade>
+    inline float clenshaw(float x, float t, float& b1, float& b2) const {
+        float x2 = 2.f * x;
+        float p1 = 0.f, p2 = 0.f, d1 = 0.f, d2 = 0.f;
+        for (size_t k = max_order; k > 0; k--) {
+            float p = previous[k] + x2 * p1 - p2;
+            p2 = p1;
+            p1 = p;
+            if constexpr (crossfade) {
+                float d = deltas[k] + x2 * d1 - d2;
+                d2 = d1;
+                d1 = d;
+            }
+        }
+        if constexpr (crossfade) {
+            b1 = p1 + t * d1;
+            b2 = p2 + t * d2;
+            return previous[0] + t * deltas[0];
+        }
+        else {
+            b1 = p1;
+            b2 = p2;
+            return previous[0];
+        }
+    }
+};
+
+/**
+ * Real valued Chebyshev series of given kind. Sum is c0 + P1(x) * b1 - b2,
+ * where P1 is the first order polynomial of that kind.
+ */
+template <size_t max_order, int kind = 1>
+class ChebyshevSeries
+    : public ChebyshevSeriesTemplate<max_order, SignalProcessor> {
+public:
+    /**
+     * Single sample jumps to current coefficients
+     */
+    float process(float input) override {
+        float output;
+        process(FloatArray(&input, 1), FloatArray(&output, 1));
+        return output;
+    }
+    void process(FloatArray input, FloatArray output) override {
+        if (this->prepare())
+            render<true>(input.getData(), output.getData(), input.getSize());
+        else
+            render<false>(input.getData(), output.getData(), input.getSize());
+        this->finish();
+    }
+
+    static ChebyshevSeries* create() {
+        return new ChebyshevSeries();
+    }
+    static void destroy(ChebyshevSeries* series) {
+        delete series;
+    }
+
+protected:
+    static_assert(kind >= 1 && kind <= 4, "Chebyshev polynomial kind must be 1 to 4");
+
+    template <bool crossfade>
+    void render(const float* input, float* output, size_t size) {
+        const float step = 1.f / size;
+        for (size_t n = 0; n < size; n++) {
+            float x = input[n];
+            float b1, b2;
+            float c0 = this->template clenshaw<crossfade>(x, (n + 1) * step, b1, b2);
+            float p1;
+            if constexpr (kind == 1)
+                p1 = x;
+            else if constexpr (kind == 2)
+                p1 = 2.f * x;
+            else if constexpr (kind == 3)
+                p1 = 2.f * x - 1.f;
+            else
+                p1 = 2.f * x + 1.f;
+            output[n] = c0 + p1 * b1 - b2;
+        }
+    }
+};
+
+/**
+ * Harmonic series of a quadrature input. For input on the unit circle
+ * (cos(w), sin(w)) output is the sum of cn * (cos(n * w), sin(n * w)).
+ *
+ * Real part is a first kind series of input real part. Imaginary part comes
+ * from the same pass, as b1 is the second kind series of shifted
+ * coefficients and sin(n * w) = sin(w) * Un-1(cos(w)).
+ */
+template <size_t max_order>
+class ComplexChebyshevSeries
+    : public ChebyshevSeriesTemplate<max_order, ComplexSignalProcessor> {
+public:
+    void setHarmonic(size_t harmonic, float level) {
+        this->setCoefficient(harmonic, level);
+    }
+    /**
+     * Single sample jumps to current coefficients
+     */
+    ComplexFloat process(ComplexFloat input) override {
+        ComplexFloat output;
+        process(ComplexFloatArray(&input, 1), ComplexFloatArray(&output, 1));
+        return output;
+    }
+    void process(ComplexFloatArray input, ComplexFloatArray output) override {
+        if (this->prepare())
+            render<true>(input.getData(), output.getData(), input.getSize());
+        else
+            render<false>(input.getData(), output.getData(), input.getSize());
+        this->finish();
+    }
+
+    static ComplexChebyshevSeries* create() {
+        return new ComplexChebyshevSeries();
+    }
+    static void destroy(ComplexChebyshevSeries* series) {
+        delete series;
+    }
+
+protected:
+    template <bool crossfade>
+    void render(const ComplexFloat* input, ComplexFloat* output, size_t size) {
+        const float step = 1.f / size;
+        for (size_t n = 0; n < size; n++) {
+            float x = input[n].re;
+            float y = input[n].im;
+            float b1, b2;
+            float c0 = this->template clenshaw<crossfade>(x, (n + 1) * step, b1, b2);
+            output[n].re = c0 + x * b1 - b2;
+            output[n].im = y * b1;
+        }
+    }
+};
+
 #endif
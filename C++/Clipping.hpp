@@ -1,6 +1,7 @@
 #ifndef _ENGINE_CLIPPING_H_
 #define _ENGINE_CLIPPING_H_
 
+#include <algorithm>
 #include <cmath>
 #include "SignalProcessor.h"
 
@@ -40,170 +41,194 @@ Reciprocal:
 sgn(x) * (1 - 1 / (|30 * x| + 1))
 */
 
-static constexpr float onesixths = 1.0f / 6.0f;
-
-class AbstractClipper : public SignalProcessor {
+/**
+ * Clipping functions with their first two antiderivatives.
+ *
+ * Every function is linear outside of [-1, 1], so antiderivatives are
+ * written as a Taylor expansion around the clamped input c = clamp(x) with
+ * d = x - c. This keeps them continuous and free of branches.
+ */
+class ClipFunction {
 public:
-    float process(float input) override {
-        return antialiasedClipN1(input);
+    static float clamp(float x) {
+        return std::min(std::max(x, -1.0f), 1.0f);
     }
+};
 
-    void process(FloatArray input, FloatArray output) {
-        for (size_t i = 0; i < input.getSize(); i++) {
-            output[i] = process(input[i]);
-        }
+class QuadraticClipFunction : public ClipFunction {
+public:
+    static float clipN0(float x) {
+        float c = clamp(x);
+        return c * std::abs(c);
     }
 
-
-    void reset() {
-        xn1 = 0.0f;
-        Fn = 0.0f;
-        Fn1 = 0.0f;
+    static float clipN1(float x) {
+        float c = clamp(x);
+        float d = x - c;
+        return std::abs(c) * (c * c / 3.0f + c * d);
     }
 
-protected:
-    // Antialiasing variables
-    float xn1;
-    float Fn;
-    float Fn1;
-    static constexpr float thresh = 10.0e-2;
-
-    virtual float clipN0(float x) = 0;
-    virtual float clipN1(float x) = 0;
-    virtual float clipN2(float x) = 0;
-
-    inline float signum(float x) {
-        return (x > 0.0f) ? 1.0f : ((x < 0.0f) ? -1.0f : 0.0f);
+    static float clipN2(float x) {
+        float c = clamp(x);
+        float d = x - c;
+        return std::abs(c) * c *
+            (c * c / 12.0f + c * d / 3.0f + 0.5f * d * d);
     }
+};
 
-    float antialiasedClipN1(float x) {
-        Fn = clipN1(x);
-        float tmp = 0.0;
-        if (abs(x - xn1) < thresh) {
-            tmp = clipN0(0.5f * (x + xn1));
-        }
-        else {
-            tmp = (Fn - Fn1) / (x - xn1);
-        }
+class CubicClipFunction : public ClipFunction {
+public:
+    static float clipN0(float x) {
+        float c = clamp(x);
+        return 1.5f * c - 0.5f * c * c * c;
+    }
 
-        // Update states
-        xn1 = x;
-        Fn1 = Fn;
+    static float clipN1(float x) {
+        float c = clamp(x);
+        float d = x - c;
+        float c2 = c * c;
+        return 0.75f * c2 - c2 * c2 / 8.0f + (1.5f * c - 0.5f * c2 * c) * d;
+    }
 
-        return tmp;
+    static float clipN2(float x) {
+        float c = clamp(x);
+        float d = x - c;
+        float c2 = c * c;
+        return c2 * c / 4.0f - c2 * c2 * c / 40.0f +
+            (0.75f * c2 - c2 * c2 / 8.0f) * d +
+            (1.5f * c - 0.5f * c2 * c) * 0.5f * d * d;
     }
 };
 
-class QuadraticClipper : public AbstractClipper {
+class SineClipFunction : public ClipFunction {
 public:
-    float clipN0(float x) override {
-        if (abs(x) < 1) {
-            return x * abs(x);
-        }
-        else {
-            return signum(x);
-        }
+    static float clipN0(float x) {
+        return sinf(float(M_PI_2) * clamp(x));
     }
 
-    float clipN1(float x) override {
-        if (abs(x) < 1) {
-            return abs(x) * x * x / 3.0f;
-        }
-        else {
-            return abs(x);
-        }
+    static float clipN1(float x) {
+        float c = clamp(x);
+        float d = x - c;
+        return float(M_2_PI) * (1 - cosf(float(M_PI_2) * c)) + c * d;
     }
-    float clipN2(float x) override {
-        if (abs(x) < 1) {
-            return abs(x) * x * x * x / 12.0f;
-        }
-        else {
-            return 0.5 * x * abs(x);
-        }
+
+    static float clipN2(float x) {
+        float c = clamp(x);
+        float d = x - c;
+        float phase = float(M_PI_2) * c;
+        return float(M_2_PI) * (c - float(M_2_PI) * sinf(phase)) +
+            float(M_2_PI) * (1 - cosf(phase)) * d + 0.5f * c * d * d;
     }
 };
 
-class CubicClipper : public AbstractClipper {
+class HardClipFunction : public ClipFunction {
 public:
-
-    float clipN0(float x) override {
-        if (abs(x) >= 1.f) {
-            return signum(x);
-//            return 2.f / 3.f * signum(x);
-        }
-        else {
-            return 1.5f * x - x * x * x / 2.f;
-//            return x - x * x * x / 3.f;
-        }
+    static float clipN0(float x) {
+        return clamp(x);
     }
 
-    float clipN1(float x) override {
-        if (abs(x) >= 1.f) {
-//        if (abs(x) >= 2.f / 3.f) {
-            return x * signum(x) - 0.5f; // abs(x) - 0.5 ?
-        }
-        else {
-            0.75f * x * x - x * x * x * x / 8.f;
-//            return x * x / 2.f - x * x * x * x / 12.f;
-        }
+    static float clipN1(float x) {
+        float c = clamp(x);
+        return 0.5f * c * c + c * (x - c);
     }
 
-    float clipN2(float x) override {
-        if (abs(x) >= 1.f) {
-            return (0.5f * x * x - onesixths) * signum(x);
-//            return x * abs(x) / 3.f;
-        }
-        else {
-            return x * x * x / 4.f - x * x * x * x / 40.f;
-//            return onesixth * x * x * x  -  x * x * x * x * x / 60.f;
-        }
+    static float clipN2(float x) {
+        float c = clamp(x);
+        float d = x - c;
+        return c * (c * c / 6.0f + 0.5f * c * d + 0.5f * d * d);
     }
 };
 
-class SineClipper : public AbstractClipper {
+/**
+ * Clipper with first order antiderivative antialiasing.
+ *
+ * Clipping function is a template parameter, so nothing is dispatched
+ * virtually per sample. Block processing evaluates antiderivatives for a
+ * chunk of samples first and then selects between difference quotient and
+ * ill-conditioned fallback without branching, so both loops vectorize.
+ */
+template <typename Function>
+class AntialiasedClipper : public SignalProcessor {
 public:
-    float clipN0(float x) override {
-        return sinf(-M_PI -
-            0.25f * M_PI * (signum(x + 1) * (x + 1) - signum(x - 1) * (x - 1)));
+    AntialiasedClipper() {
+        reset();
     }
 
-    float clipN1(float x) override {
-        return 4 / M_PI +
-            4 / M_PI *
-            cosf(-M_PI -
-                0.25f * M_PI * (signum(x + 1) * (x + 1) - signum(x - 1) * (x - 1)));
+    float process(float input) override {
+        return antialiasedClipN1(input);
     }
 
-    float clipN2(float x) override {
-        // second antiderivative of hardClipN0
-        /// TODO
-        return 0.f;
+    void process(FloatArray input, FloatArray output) override {
+        const float* in = input.getData();
+        float* out = output.getData();
+        size_t size = input.getSize();
+        // Previous sample is stored at index 0
+        float x[chunk_size + 1];
+        float F[chunk_size + 1];
+        while (size) {
+            size_t len = size < chunk_size ? size : chunk_size;
+            x[0] = xn1;
+            F[0] = Fn1;
+            for (size_t i = 0; i < len; i++) {
+                x[i + 1] = in[i];
+                F[i + 1] = Function::clipN1(in[i]);
+            }
+            for (size_t i = 0; i < len; i++) {
+                float dx = x[i + 1] - x[i];
+                bool ill = std::abs(dx) < thresh;
+                float fallback = Function::clipN0(0.5f * (x[i + 1] + x[i]));
+                float quotient = (F[i + 1] - F[i]) / (ill ? 1.0f : dx);
+                out[i] = ill ? fallback : quotient;
+            }
+            xn1 = x[len];
+            Fn1 = F[len];
+            in += len;
+            out += len;
+            size -= len;
+        }
     }
-};
 
-class HardClipper : public AbstractClipper {
-public:
-    float clipN0(float x) override {
-        // Hard clipping function
-        return 0.5f * (signum(x + 1.0f) * (x + 1.0f) - signum(x - 1.0f) * (x - 1.0f));
+    void reset() {
+        xn1 = 0.0f;
+        Fn1 = 0.0f;
     }
 
-    float clipN1(float x) override {
-        // First antiderivative of hardClipN0
-        return 0.25f *
-            (signum(x + 1.0f) * (x + 1.0f) * (x + 1.0f) -
-                signum(x - 1.0f) * (x - 1.0f) * (x - 1.0f) - 2.0f);
+    static AntialiasedClipper* create() {
+        return new AntialiasedClipper();
     }
 
-    float clipN2(float x) override {
-        // second antiderivative of hardClipN0
-        return oneTwelfth *
-            (signum(x + 1.0f) * (x + 1.0f) * (x + 1.0f) * (x + 1.0f) -
-                signum(x - 1.0f) * (x - 1.0f) * (x - 1.0f) * (x - 1.0f) - 6.0f * x);
+    static void destroy(AntialiasedClipper* clipper) {
+        delete clipper;
     }
 
-private:
-    static constexpr float oneTwelfth = 1.0 / 12.0;
+protected:
+    // Antialiasing variables
+    float xn1;
+    float Fn1;
+    static constexpr float thresh = 10.0e-2;
+    static constexpr size_t chunk_size = 32;
+
+    float antialiasedClipN1(float x) {
+        float Fn = Function::clipN1(x);
+        float tmp;
+        if (std::abs(x - xn1) < thresh) {
+            tmp = Function::clipN0(0.5f * (x + xn1));
+        }
+        else {
+            tmp = (Fn - Fn1) / (x - xn1);
+        }
+
+        // Update states
+        xn1 = x;
+        Fn1 = Fn;
+
+        return tmp;
+    }
 };
 
+using QuadraticClipper = AntialiasedClipper<QuadraticClipFunction>;
+using CubicClipper = AntialiasedClipper<CubicClipFunction>;
+using SineClipper = AntialiasedClipper<SineClipFunction>;
+using HardClipper = AntialiasedClipper<HardClipFunction>;
+
 #endif
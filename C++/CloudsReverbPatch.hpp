@@ -1,4 +1,4 @@
-#include "DattorroReverb.hpp"
+#include "DattorroBlockReverb.hpp"
 #include "Patch.h"
 #include "Nonlinearity.hpp"
 #include "SmoothValue.h"
@@ -15,7 +15,7 @@
 #define MAX_PRE_DELAY 120 // In ms
 
 using Saturator = BypassProcessor<AntialiasedThirdOrderPolynomial>;
-using CloudsReverb = DattorroReverb<true>;
+using CloudsReverb = DattorroBlockReverb<true>;
 
 class CloudsReverbPatch : public Patch {
 public:
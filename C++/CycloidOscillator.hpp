@@ -2,6 +2,7 @@
 #define __CYCLOID_OSCILLATOR_HPP__
 
 #include "ComplexOscillator.h"
+#include "LinearRamp.hpp"
 
 /**
  * A complex (quadrature) oscillator based on epicycloid/hypocycloid
@@ -37,10 +38,16 @@ public:
         return (2 * M_PI) / mul;
     }
     void setFrequency(float freq) {
-        incr = freq * mul;
+        incr.set(freq * mul);
+    }
+    /**
+     * Ramp frequency over next rendered block
+     */
+    void rampFrequency(float freq) {
+        incr.ramp(freq * mul);
     }
     float getFrequency() {
-        return incr / mul;
+        return incr.getEnd() / mul;
     }
     void setPhase(float ph) {
         modPhase += (ph - phase) * ratio;
@@ -53,16 +60,29 @@ public:
         feedback1 = feedback;
     }*/
     void setFeedback(float magnitude, float phase, float a = 1.f, float b = 1.f) {
-        feedback.setPolar(magnitude, phase);
+        feedback_re.set(magnitude * cosf(phase));
+        feedback_im.set(magnitude * sinf(phase));
+        fb_a_amt = a;
+        fb_b_amt = b;
+    }
+    /**
+     * Ramp feedback over next rendered block, a and b amounts are applied
+     * immediately
+     */
+    void rampFeedback(float magnitude, float phase, float a = 1.f, float b = 1.f) {
+        feedback_re.ramp(magnitude * cosf(phase));
+        feedback_im.ramp(magnitude * sinf(phase));
         fb_a_amt = a;
         fb_b_amt = b;
     }
     void setHarmonics(float harmonics) {
-        this->harmonics = harmonics;
+        this->harmonics.set(harmonics);
+    }
+    void rampHarmonics(float harmonics) {
+        this->harmonics.ramp(harmonics);
     }
     void setRatio(float ratio) {
         this->ratio = ratio;
-        ratioIncr = incr * ratio;
     }
     void generate(ComplexFloatArray output) override {
         render<false>(output.getSize(), NULL, output.getData());
@@ -80,35 +100,46 @@ public:
 
 protected:
     float mul = 0.f;
-    float incr = 0.f;
-    float ratioIncr = 0.f;
+    LinearRamp<float> incr = 0.f;
     float phase = 0.f;
-    float harmonics = 1.f;
+    LinearRamp<float> harmonics = 1.f;
     float ratio = 1.f;
     float modPhase = 0.f;
-    ComplexFloat feedback;
+    LinearRamp<float> feedback_re = 0.f, feedback_im = 0.f;
     float fb_a_amt = 1.f, fb_b_amt = 1.f;
     float last_x = 0.f, last_y = 0.f, last_t = 0.f;
 
     template <bool with_fm>
     void render(size_t size, float* fm, ComplexFloat* out) {
-        float h = harmonics;
-        float h_rev = 1.f - harmonics;
+        // Parameters are ramped, step is 0 when they were set directly
+        float inc = incr.getStart();
+        const float inc_step = incr.getStep(size);
+        float h = harmonics.getStart();
+        const float h_step = harmonics.getStep(size);
+        float fb_re = feedback_re.getStart();
+        const float fb_re_step = feedback_re.getStep(size);
+        float fb_im = feedback_im.getStart();
+        const float fb_im_step = feedback_im.getStep(size);
         float ph = phase;
         float mph = modPhase;
         while (size--) {
+            inc += inc_step;
+            h += h_step;
+            fb_re += fb_re_step;
+            fb_im += fb_im_step;
+            float h_rev = 1.f - h;
             //            float x = h_rev * cos(ph) + h * cos(mph + last_x * feedback.re);
             //            float y = h_rev * sin(ph) + h * sin(mph + last_y * feedback.im);
-            float fb_x = last_x * feedback.re;
-            float fb_y = last_y * feedback.im;
+            float fb_x = last_x * fb_re;
+            float fb_y = last_y * fb_im;
             float x = h_rev * cos(ph + fb_x * fb_a_amt) + h * cos(mph + fb_x * fb_b_amt);
             float y = h_rev * sin(ph + fb_y * fb_a_amt) + h * sin(mph + fb_y * fb_b_amt);
 
             //            float x = cosf(phase + last_x * feedback2.re) * t;
             //            float y = sinf(phase + last_y * feedback2.im) * t;
 
-            ph += incr;
-            mph += ratioIncr;
+            ph += inc;
+            mph += inc * ratio;
             if constexpr(with_fm) {
                 //                modPhase += *fm;
                 phase += *fm;
@@ -131,6 +162,10 @@ protected:
         while (mph < 0)
             mph += M_PI * 2.f;
         modPhase = mph;
+        incr.finish();
+        harmonics.finish();
+        feedback_re.finish();
+        feedback_im.finish();
     }
 };
 
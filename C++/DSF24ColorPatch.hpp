@@ -106,8 +106,8 @@
 
 using SmoothParam = LockableValue<SmoothValue<float>, float>;
 using StiffParam = LockableValue<StiffValue<float>, float>;
-using MorphBase =
-    StereoMorphingOscillator<DiscreteSummationOscillator<DSF2>, DiscreteSummationOscillator<DSF4>>;
+using MorphBase = StereoMorphingOscillator<DiscreteSummationOscillator<DSF2, true>,
+    DiscreteSummationOscillator<DSF4, true>>;
 using StereoWavefolder = MultiProcessor<AntialiasedWaveFolder<HardClip>, 2>;
 using ColourBuffer = CircularBuffer<Pixel>;
 
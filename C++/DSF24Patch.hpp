@@ -105,8 +105,8 @@
 
 using SmoothParam = LockableValue<SmoothValue<float>, float>;
 using StiffParam = LockableValue<StiffValue<float>, float>;
-using MorphBase =
-    StereoMorphingOscillator<DiscreteSummationOscillator<DSF2>, DiscreteSummationOscillator<DSF4>>;
+using MorphBase = StereoMorphingOscillator<DiscreteSummationOscillator<DSF2, true>,
+    DiscreteSummationOscillator<DSF4, true>>;
 using StereoWavefolder = MultiProcessor<Wavefolder<HardClipper>, 2>;
 using OscPreview = MonochromeQuadraturePreview<256, 4, uint8_t>;
 using CVPreview = MonochromeQuadraturePreview<128, 1, uint8_t>;
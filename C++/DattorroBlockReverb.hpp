@@ -0,0 +1,328 @@
+#ifndef __DATTORRO_BLOCK_REVERB_HPP__
+#define __DATTORRO_BLOCK_REVERB_HPP__
+
+#include "DattorroReverb.hpp"
+
+/**
+ * Block based version of DattorroReverb with the same topology, parameters
+ * and sound.
+ *
+ * All delay lines are stored in a single power of two sized buffer that
+ * rotates with one write pointer, so every access is an add and a mask.
+ * LFOs are rendered once per block, input diffusers are processed one stage
+ * at a time over the whole block and only the tank loop runs per sample.
+ *
+ * Modulated reads must stay shorter than the delay lines they read from.
+ */
+template <bool with_smear = true, typename Processor = bypass>
+class DattorroBlockReverb : public MultiSignalProcessor {
+private:
+    static constexpr size_t num_delays = 10;
+    using Delays = ReverbDelays<num_delays>;
+    Processor** processors;
+
+public:
+    DattorroBlockReverb() = default;
+    DattorroBlockReverb(CrossFadingCircularFloatBuffer* pre_delay, FloatArray tmp,
+        FloatArray mod1, FloatArray mod2, FloatArray buffer,
+        const size_t* delay_lengths, float sr, float delay_scale,
+        Processor** processors)
+        : pre_delay(pre_delay)
+        , pre_delay_prev(0)
+        , pre_delay_next(0)
+        , tmp(tmp)
+        , mod1(mod1)
+        , mod2(mod2)
+        , buffer(buffer)
+        , mask(buffer.getSize() - 1)
+        , write_ptr(0)
+        , lfo1_phase(0)
+        , lfo2_phase(0)
+        , lfo1_step(2 * M_PI * 0.5 / sr)
+        , lfo2_step(2 * M_PI * 0.3 / sr)
+        , damping(0)
+        , lp1_state(0)
+        , lp2_state(0)
+        , diffusion(0)
+        , amount(0)
+        , decay(0)
+        , lfo_offset1(0)
+        , lfo_offset2(0)
+        , lfo_amount1(0)
+        , lfo_amount2(0)
+        , delay_scale(delay_scale)
+        , smear_offset(Delays::scale(100, delay_scale)) // Hardcoded for now
+        , frozen(false)
+        , processors(processors) {
+        size_t base = 0;
+        for (size_t i = 0; i < num_delays; i++) {
+            lengths[i] = delay_lengths[i];
+            bases[i] = base;
+            base += getStoredLength(i, delay_lengths[i]);
+        }
+        buffer.clear();
+    }
+
+    void process(AudioBuffer& input, AudioBuffer& output) {
+        // Same Griesinger topology as in DattorroReverb. Input diffusers are
+        // feed-forward, so each of them can process the whole block before
+        // the next one.
+
+        const float kap = diffusion;
+        const float klp = frozen ? 1 : damping;
+        const float krt = frozen ? 1 : decay;
+
+        size_t size = input.getSize();
+
+        float* left_in = input.getSamples(0).getData();
+        float* right_in = input.getSamples(1).getData();
+        float* left_out = output.getSamples(0).getData();
+        float* right_out = output.getSamples(1).getData();
+
+        if (frozen) {
+            tmp.clear();
+        }
+        else {
+            tmp.copyFrom(input.getSamples(0));
+            tmp.add(input.getSamples(1));
+            tmp.multiply(0.5);
+        }
+
+        float* in = tmp.getData();
+        pre_delay->delay(in, in, tmp.getSize(), pre_delay_prev, pre_delay_next);
+
+        // Modulated read positions, in samples ago. LFOs are slow enough
+        // to be interpolated linearly over a block.
+        FloatArray lfo1_pos = mod1.subArray(0, size);
+        FloatArray lfo2_pos = mod2.subArray(0, size);
+        const float lfo1_amount = with_smear ? lfo_amount1 : -lfo_amount1;
+        lfo1_pos.ramp(lfo_offset1 + (sinf(lfo1_phase) + 1) * lfo1_amount,
+            lfo_offset1 + (sinf(lfo1_phase + lfo1_step * size) + 1) * lfo1_amount);
+        lfo2_pos.ramp(lfo_offset2 - (sinf(lfo2_phase) + 1) * lfo_amount2,
+            lfo_offset2 - (sinf(lfo2_phase + lfo2_step * size) + 1) * lfo_amount2);
+        lfo1_phase = wrapPhase(lfo1_phase + lfo1_step * size);
+        lfo2_phase = wrapPhase(lfo2_phase + lfo2_step * size);
+
+        // Diffuse through 4 allpasses, smearing AP1 inside its loop
+        size_t first_stage = 0;
+        if constexpr (with_smear) {
+            const float* pos = lfo1_pos.getData();
+            size_t line = write_ptr + bases[0];
+            const size_t smear_write = lengths[0] - smear_offset;
+            for (size_t n = 0; n < size; n++) {
+                buffer[(line + smear_write) & mask] = readAt(line, pos[n]);
+                processAPF(line--, lengths[0], in[n], kap);
+            }
+            first_stage = 1;
+        }
+        for (size_t i = first_stage; i < 4; i++) {
+            size_t line = write_ptr + bases[i];
+            for (size_t n = 0; n < size; n++) {
+                processAPF(line--, lengths[i], in[n], kap);
+            }
+        }
+
+        // Main reverb loop
+        const float* lfo1_data = lfo1_pos.getData();
+        const float* lfo2_data = lfo2_pos.getData();
+        float lp1 = lp1_state;
+        float lp2 = lp2_state;
+        for (size_t n = 0; n < size; n++) {
+            const size_t ptr = write_ptr - n;
+            float apout = in[n];
+
+            // Modulate interpolated delay line
+            float acc = apout + readAt(ptr + bases[9], lfo2_data[n]) * krt;
+            // Filter followed by two APFs
+            processLPF(lp1, acc, klp);
+            processAPF(ptr + bases[4], lengths[4], acc, -kap);
+            processAPF(ptr + bases[5], lengths[5], acc, kap);
+            if constexpr (!std::is_empty<Processor>::value)
+                acc = processors[0]->process(acc);
+
+            *left_out++ = *left_in + (acc - *left_in) * amount;
+            left_in++;
+
+            if constexpr (with_smear) {
+                // DattorroReverb reads this delay right after writing it,
+                // so it is kept without storage
+                acc = apout + acc * krt;
+            }
+            else {
+                buffer[(ptr + bases[6]) & mask] = acc;
+                acc = apout + readAt(ptr + bases[6], lfo1_data[n]) * krt;
+            }
+            processLPF(lp2, acc, klp);
+            processAPF(ptr + bases[7], lengths[7], acc, kap);
+            processAPF(ptr + bases[8], lengths[8], acc, -kap);
+            if constexpr (!std::is_empty<Processor>::value)
+                acc = processors[1]->process(acc);
+
+            buffer[(ptr + bases[9]) & mask] = acc;
+
+            *right_out++ = *right_in + (acc - *right_in) * amount;
+            right_in++;
+        }
+        lp1_state = lp1;
+        lp2_state = lp2;
+        write_ptr -= size;
+    }
+
+    Processor& getProcessor(size_t index) {
+        return *processors[index];
+    }
+
+    void setAmount(float amount) {
+        this->amount = amount;
+    }
+
+    void setDecay(float decay) {
+        this->decay = decay;
+    }
+
+    void setDiffusion(float diffusion) {
+        this->diffusion = diffusion;
+    }
+
+    void setDamping(float damping) {
+        this->damping = Delays::scaleDamping(damping, delay_scale);
+    }
+
+    /**
+     * Frozen reverb ignores input and sustains its tail indefinitely
+     */
+    void setFreeze(bool freeze) {
+        frozen = freeze;
+    }
+
+    bool isFrozen() {
+        return frozen;
+    }
+
+    void setPreDelay(size_t pre_delay) {
+        pre_delay_prev = pre_delay_next;
+        pre_delay_next = pre_delay;
+    }
+
+    void clear() {
+        buffer.clear();
+    }
+
+    /**
+     * Set modulation offsets and amounts in samples at sample rate of the
+     * delay table
+     */
+    void setModulation(size_t offset1, size_t amount1, size_t offset2, size_t amount2) {
+        lfo_offset1 = Delays::scale(offset1, delay_scale);
+        lfo_amount1 = (amount1 / 2) * delay_scale;
+        lfo_offset2 = Delays::scale(offset2, delay_scale);
+        lfo_amount2 = (amount2 / 2) * delay_scale;
+    }
+
+    template <typename... Args>
+    static DattorroBlockReverb* create(size_t pre_delay_max, size_t block_size,
+        float sr, const Delays& delay_table, Args&&... args) {
+        size_t delay_lengths[num_delays];
+        delay_table.scale(sr, delay_lengths);
+        size_t total = 0;
+        for (size_t i = 0; i < num_delays; i++) {
+            total += getStoredLength(i, delay_lengths[i]);
+        }
+        size_t buffer_size = 1;
+        while (buffer_size < total)
+            buffer_size <<= 1;
+        FloatArray buffer = FloatArray::create(buffer_size);
+        FloatArray mod1 = FloatArray::create(block_size);
+        FloatArray mod2 = FloatArray::create(block_size);
+
+        CrossFadingCircularFloatBuffer* pre_delay =
+            CrossFadingCircularFloatBuffer::create(pre_delay_max, block_size);
+        FloatArray tmp = FloatArray::create(block_size);
+
+        Processor** processors = nullptr;
+        if constexpr (!std::is_empty<Processor>::value) {
+            processors = new Processor*[2];
+            processors[0] = Processor::create(std::forward<Args>(args)...);
+            processors[1] = Processor::create(std::forward<Args>(args)...);
+        }
+        return new DattorroBlockReverb(pre_delay, tmp, mod1, mod2, buffer,
+            delay_lengths, sr, delay_table.getScale(sr), processors);
+    }
+
+    static void destroy(DattorroBlockReverb* reverb) {
+        FloatArray::destroy(reverb->buffer);
+        FloatArray::destroy(reverb->mod1);
+        FloatArray::destroy(reverb->mod2);
+        if constexpr (!std::is_empty<Processor>::value) {
+            Processor::destroy(reverb->processors[0]);
+            Processor::destroy(reverb->processors[1]);
+            delete[] reverb->processors;
+        }
+        CrossFadingCircularFloatBuffer::destroy(reverb->pre_delay);
+        FloatArray::destroy(reverb->tmp);
+        delete reverb;
+    }
+
+protected:
+    CrossFadingCircularFloatBuffer* pre_delay;
+    size_t pre_delay_prev, pre_delay_next;
+    FloatArray tmp;
+    FloatArray mod1, mod2;
+    /**
+     * Delay line i stores sample written k samples ago at
+     * (write_ptr + bases[i] + k) & mask. Lines are packed without gaps: the
+     * oldest sample of a line shares its slot with the newest sample of the
+     * next line and is always read before that gets written.
+     */
+    FloatArray buffer;
+    size_t mask;
+    size_t write_ptr;
+    size_t bases[num_delays];
+    size_t lengths[num_delays];
+    float lfo1_phase, lfo2_phase;
+    float lfo1_step, lfo2_step;
+    float damping;
+    float lp1_state, lp2_state;
+    float diffusion;
+    float amount;
+    float decay;
+    float lfo_offset1, lfo_offset2;
+    float lfo_amount1, lfo_amount2;
+    float delay_scale;
+    size_t smear_offset;
+    bool frozen;
+
+    static size_t getStoredLength(size_t index, size_t length) {
+        return with_smear && index == 6 ? 0 : length;
+    }
+
+    static float wrapPhase(float phase) {
+        return phase >= 2 * M_PI ? phase - 2 * M_PI : phase;
+    }
+
+    inline void processLPF(float& state, float& value, float klp) {
+        state += klp * (value - state);
+        value = state;
+    }
+
+    inline void processAPF(size_t line, size_t length, float& acc, float kap) {
+        float sample = buffer[(line + length) & mask];
+        acc += sample * kap;
+        buffer[line & mask] = acc;
+        acc *= -kap;
+        acc += sample;
+    }
+
+    /**
+     * Linear interpolated read, position is in samples ago
+     */
+    inline float readAt(size_t line, float position) {
+        size_t index = (size_t)position;
+        float frac = position - index;
+        float low = buffer[(line + index) & mask];
+        float high = buffer[(line + index + 1) & mask];
+        return low + (high - low) * frac;
+    }
+};
+
+#endif
@@ -2,21 +2,69 @@
 #define __DATTORRO_REVERB_HPP__
 
 #include "OpenWareLibrary.h"
+#include "ReverbDelays.hpp"
 
 class bypass { };
 
-template <bool with_smear = true, typename Processor = bypass>
+/**
+ * Output tap on a tank delay line, position is relative to line length
+ */
+struct DattorroTap {
+    size_t line;
+    float position;
+    float gain;
+};
+
+/**
+ * Left and right output taps from the Dattorro paper mapped to tank lines:
+ * each tank branch has 2 APFs and a delay in place of the paper's delay,
+ * APF and delay. The paper's 1913 samples tap on an 1800 samples APF
+ * doesn't fit, so it reads the end of that line instead. Gains are half of
+ * the paper's 0.6 to match level of branch outputs.
+ */
+const DattorroTap dattorro_taps[2][7] = {
+    {
+        { 4, 266.f / 4453, 0.3f },
+        { 4, 2974.f / 4453, 0.3f },
+        { 5, 1.f, -0.3f },
+        { 6, 1996.f / 3720, 0.3f },
+        { 7, 1990.f / 4217, -0.3f },
+        { 8, 187.f / 2656, -0.3f },
+        { 9, 1066.f / 3163, -0.3f },
+    },
+    {
+        { 7, 353.f / 4217, 0.3f },
+        { 7, 3627.f / 4217, 0.3f },
+        { 8, 1228.f / 2656, -0.3f },
+        { 9, 2673.f / 3163, 0.3f },
+        { 4, 2111.f / 4453, -0.3f },
+        { 5, 335.f / 1800, -0.3f },
+        { 6, 121.f / 3720, -0.3f },
+    },
+};
+
+/**
+ * Mono input Dattorro/Griesinger reverb.
+ *
+ * By default left and right outputs are taken from the ends of the two
+ * tank branches. With with_taps set, each output sums taps spread across
+ * the whole tank instead, which gives decorrelated stereo from a single tank.
+ */
+template <bool with_smear = true, typename Processor = bypass, bool with_taps = false>
 class DattorroReverb : public MultiSignalProcessor {
 private:
     using LFO = SineOscillator;
     using DelayBuffer = InterpolatingCircularFloatBuffer<LINEAR_INTERPOLATION>;
     static constexpr size_t num_delays = 10;
+    static constexpr size_t num_taps = 7;
+    using Delays = ReverbDelays<num_delays>;
     Processor** processors;
 
 public:
     DattorroReverb() = default;
     DattorroReverb(CrossFadingCircularFloatBuffer* pre_delay, FloatArray tmp,
-        DelayBuffer** delays, LFO* lfo1, LFO* lfo2, Processor** processors)
+        DelayBuffer** delays, LFO* lfo1, LFO* lfo2, float delay_scale,
+        Processor** processors)
         : pre_delay(pre_delay)
         , pre_delay_prev(0)
         , pre_delay_next(0)
@@ -32,12 +80,23 @@ public:
         , decay(0)
         , lfo_amount1(0)
         , lfo_amount2(0)
+        , delay_scale(delay_scale)
+        , smear_offset(Delays::scale(100, delay_scale)) // Hardcoded for now
+        , frozen(false)
         , processors(processors) {
         lfo1->setFrequency(0.5);
         lfo2->setFrequency(0.3);
         for (size_t i = 0; i < num_delays; i++) {
             delays[i]->setDelay((int)delays[i]->getSize());
         }
+        for (size_t ch = 0; ch < 2; ch++) {
+            for (size_t i = 0; i < num_taps; i++) {
+                const DattorroTap& tap = dattorro_taps[ch][i];
+                size_t length = delays[tap.line]->getSize();
+                size_t delay = tap.position * length;
+                tap_delays[ch][i] = delay < 1 ? 1 : delay > length ? length : delay;
+            }
+        }
     }
     void process(AudioBuffer& input, AudioBuffer& output) {
         // This is the Griesinger topology described in the Dattorro paper
@@ -45,9 +104,11 @@ public:
         // Modulation is applied in the loop of the first diffuser AP for additional
         // smearing; and to the two long delays for a slow shimmer/chorus effect.
 
+        // Freezing only changes coefficients: no new input, no damping
+        // and no decay
         const float kap = diffusion;
-        const float klp = damping;
-        const float krt = decay;
+        const float klp = frozen ? 1 : damping;
+        const float krt = frozen ? 1 : decay;
 
         size_t size = input.getSize();
 
@@ -60,7 +121,7 @@ public:
         if constexpr (with_smear) {
             lfo1_read_offset =
                 delays[0]->getWriteIndex() + delays[0]->getSize() - lfo_offset1;
-            lfo1_write_offset = delays[0]->getWriteIndex() + 100; // Hardcoded for now
+            lfo1_write_offset = delays[0]->getWriteIndex() + smear_offset;
         }
         else {
             lfo1_read_offset =
@@ -69,9 +130,14 @@ public:
         lfo2_read_offset =
             delays[9]->getWriteIndex() + delays[9]->getSize() - lfo_offset2;
 
-        tmp.copyFrom(input.getSamples(0));
-        tmp.add(input.getSamples(1));
-        tmp.multiply(0.5);
+        if (frozen) {
+            tmp.clear();
+        }
+        else {
+            tmp.copyFrom(input.getSamples(0));
+            tmp.add(input.getSamples(1));
+            tmp.multiply(0.5);
+        }
 
         float* in = tmp.getData();
         pre_delay->delay(in, in, tmp.getSize(), pre_delay_prev, pre_delay_next);
@@ -103,7 +169,7 @@ public:
                        (lfo2->generate() + 1) * lfo_amount2 + lfo2_read_offset++) *
                 krt;
             // Filter followed by two APFs
-            processLPF(lp1_state, acc);
+            processLPF(lp1_state, acc, klp);
             processAPF(delays[4], acc, -kap);
             processAPF(delays[5], acc, kap);
             if constexpr (!std::is_empty<Processor>::value)
@@ -111,8 +177,7 @@ public:
 
             delays[6]->write(acc);
 
-            *left_out++ = *left_in + (acc - *left_in) * amount;
-            *left_in++;
+            float left = acc;
 
             acc = apout;
             if constexpr (with_smear) {
@@ -123,7 +188,7 @@ public:
                            lfo1_read_offset++) *
                     krt;
             }
-            processLPF(lp2_state, acc);
+            processLPF(lp2_state, acc, klp);
             processAPF(delays[7], acc, kap);
             processAPF(delays[8], acc, -kap);
             if constexpr (!std::is_empty<Processor>::value)
@@ -131,7 +196,15 @@ public:
 
             delays[9]->write(acc);
 
-            *right_out++ = *right_in + (acc - *right_in) * amount;
+            float right = acc;
+            if constexpr (with_taps) {
+                left = readTaps(0);
+                right = readTaps(1);
+            }
+
+            *left_out++ = *left_in + (left - *left_in) * amount;
+            *left_in++;
+            *right_out++ = *right_in + (right - *right_in) * amount;
             *right_in++;
         }
     }
@@ -153,7 +226,18 @@ public:
     }
 
     void setDamping(float damping) {
-        this->damping = damping;
+        this->damping = Delays::scaleDamping(damping, delay_scale);
+    }
+
+    /**
+     * Frozen reverb ignores input and sustains its tail indefinitely
+     */
+    void setFreeze(bool freeze) {
+        frozen = freeze;
+    }
+
+    bool isFrozen() {
+        return frozen;
     }
 
     void setPreDelay(size_t pre_delay) {
@@ -167,16 +251,23 @@ public:
         }
     }
 
+    /**
+     * Set modulation offsets and amounts in samples at sample rate of the
+     * delay table
+     */
     void setModulation(size_t offset1, size_t amount1, size_t offset2, size_t amount2) {
-        lfo_offset1 = offset1;
-        lfo_amount1 = amount1 / 2;
-        lfo_offset2 = offset2;
-        lfo_amount2 = amount2 / 2;
+        lfo_offset1 = Delays::scale(offset1, delay_scale);
+        lfo_amount1 = (amount1 / 2) * delay_scale;
+        lfo_offset2 = Delays::scale(offset2, delay_scale);
+        lfo_amount2 = (amount2 / 2) * delay_scale;
     }
 
     template <typename... Args>
     static DattorroReverb* create(size_t pre_delay_max, size_t block_size,
-        float sr, const size_t* delay_lengths, Args&&... args) {
+        float sr, const Delays& delay_table, Args&&... args) {
+        size_t delay_lengths[num_delays];
+        delay_table.scale(sr, delay_lengths);
+        float delay_scale = delay_table.getScale(sr);
         DelayBuffer** delays = new DelayBuffer*[num_delays];
         for (size_t i = 0; i < num_delays; i++) {
             delays[i] = DelayBuffer::create(delay_lengths[i]);
@@ -190,13 +281,14 @@ public:
 
         if constexpr (std::is_empty<Processor>::value) {
             return new DattorroReverb(
-                pre_delay, tmp, delays, lfo1, lfo2, nullptr);
+                pre_delay, tmp, delays, lfo1, lfo2, delay_scale, nullptr);
         }
         else {
             Processor** processors = new Processor*[2];
             processors[0] = Processor::create(std::forward<Args>(args)...);
             processors[1] = Processor::create(std::forward<Args>(args)...);
-            return new DattorroReverb(pre_delay, tmp, delays, lfo1, lfo2, processors);
+            return new DattorroReverb(
+                pre_delay, tmp, delays, lfo1, lfo2, delay_scale, processors);
         }
     }
 
@@ -228,13 +320,17 @@ protected:
     float lp1_state, lp2_state;
     float hp1_state, hp2_state;
     size_t lfo_offset1, lfo_offset2;
-    size_t lfo_amount1, lfo_amount2;
+    float lfo_amount1, lfo_amount2;
+    float delay_scale;
+    size_t smear_offset;
+    bool frozen;
+    size_t tap_delays[2][num_taps];
     FloatArray tmp;
     CrossFadingCircularFloatBuffer* pre_delay;
     size_t pre_delay_prev, pre_delay_next;
 
-    inline void processLPF(float& state, float& value) {
-        state += damping * (value - state);
+    inline void processLPF(float& state, float& value, float klp) {
+        state += klp * (value - state);
         value = state;
     }
 
@@ -250,10 +346,21 @@ protected:
         acc *= -kap;
         acc += sample;
     }
+
+    inline float readTaps(size_t channel) {
+        float out = 0;
+        for (size_t i = 0; i < num_taps; i++) {
+            DelayBuffer* delay = delays[dattorro_taps[channel][i].line];
+            out += delay->readAt(delay->getWriteIndex() + delay->getSize() -
+                       tap_delays[channel][i]) *
+                dattorro_taps[channel][i].gain;
+        }
+        return out;
+    }
 };
 
 // Rings, elements - has longer tails
-const size_t rings_delays[] = {
+const ReverbDelays<10> rings_delays = { 48000, {
     150,
     214,
     319,
@@ -264,9 +371,9 @@ const size_t rings_delays[] = {
     2525,
     2197,
     6312,
-};
+} };
 // The nephologic classic
-const size_t clouds_delays[] = {
+const ReverbDelays<10> clouds_delays = { 48000, {
     113,
     162,
     241,
@@ -277,9 +384,10 @@ const size_t clouds_delays[] = {
     1913,
     1663,
     4782,
-};
+} };
 // Jon Dattorro, Effect Design 1:  Reverberator  and  Other  Filters
-const size_t dattorro_delays[] = {
+// (tuned for 29761 Hz)
+const ReverbDelays<10> dattorro_delays = { 29761, {
     142,
     107,
     379,
@@ -290,5 +398,5 @@ const size_t dattorro_delays[] = {
     4217,
     3163,
     672 + 50,
-};
+} };
 #endif
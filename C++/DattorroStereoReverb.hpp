@@ -2,6 +2,7 @@
 #define __DATTORRO_REVERB_HPP__
 
 #include "OpenWareLibrary.h"
+#include "ReverbDelays.hpp"
 
 class bypass { };
 
@@ -11,12 +12,13 @@ private:
     using LFO = SineOscillator;
     using DelayBuffer = InterpolatingCircularFloatBuffer<LINEAR_INTERPOLATION>;
     static constexpr size_t num_delays = 14;
+    using Delays = ReverbDelays<num_delays>;
     Processor** processors;
 
 public:
     DattorroStereoReverb() = default;
     DattorroStereoReverb(FloatArray tmp, DelayBuffer** delays, LFO* lfo1,
-        LFO* lfo2, Processor** processors)
+        LFO* lfo2, float delay_scale, Processor** processors)
         : tmp(tmp)
         , delays(delays)
         , lfo1(lfo1)
@@ -32,6 +34,9 @@ public:
         , decay(0)
         , lfo_amount1(0)
         , lfo_amount2(0)
+        , delay_scale(delay_scale)
+        , smear_offset(Delays::scale(100, delay_scale)) // Hardcoded for now
+        , frozen(false)
         , processors(processors) {
         lfo1->setFrequency(0.5);
         lfo2->setFrequency(0.3);
@@ -45,14 +50,19 @@ public:
         // Modulation is applied in the loop of the first diffuser AP for additional
         // smearing; and to the two long delays for a slow shimmer/chorus effect.
 
+        // Freezing only changes coefficients and feeds silence to diffusers
         const float kap = diffusion;
-        const float klp = damping;
-        const float krt = decay;
+        const float klp = frozen ? 1 : damping;
+        const float krt = frozen ? 1 : decay;
 
         size_t size = input.getSize();
 
         float* left_in = input.getSamples(0).getData();
         float* right_in = input.getSamples(1).getData();
+        if (frozen)
+            tmp.clear();
+        const float* left_src = frozen ? tmp.getData() : left_in;
+        const float* right_src = frozen ? tmp.getData() : right_in;
         float* left_out = output.getSamples(0).getData();
         float* right_out = output.getSamples(1).getData();
 
@@ -66,8 +76,8 @@ public:
                 delays[0]->getWriteIndex() + delays[0]->getSize() - lfo_offset1;
             lfo1_read_offset_alt =
                 delays[4]->getWriteIndex() + delays[4]->getSize() - lfo_offset1;
-            lfo1_write_offset = delays[0]->getWriteIndex() + 100; // Hardcoded for now
-            lfo1_write_offset_alt = delays[4]->getWriteIndex() + 100; // Hardcoded for now
+            lfo1_write_offset = delays[0]->getWriteIndex() + smear_offset;
+            lfo1_write_offset_alt = delays[4]->getWriteIndex() + smear_offset;
         }
         else {
             lfo1_read_offset =
@@ -93,7 +103,7 @@ public:
             }
 
             // Left channel
-            float acc = *left_in;
+            float acc = *left_src++;
 
             // Diffuse through 4 allpasses.
             for (size_t i = 0; i < 4; i++) {
@@ -106,20 +116,20 @@ public:
                        (lfo2->generate() + 1) * lfo_amount2 + lfo2_read_offset++) *
                 krt;
             // Filter followed by two APFs
-            processLPF(lp1_state, acc);
+            processLPF(lp1_state, acc, klp);
             processAPF(delays[8], acc, -kap);
             processAPF(delays[9], acc, kap);
             if constexpr (!std::is_empty<Processor>::value)
                 acc = processors[0]->process(acc);
 
-            processHPF(hp1_state, acc);
+            processHPF(hp1_state, acc, klp);
             delays[10]->write(acc);
 
             *left_out++ = *left_in + (acc - *left_in) * amount;
             *left_in++;
 
             // Right channel
-            acc = *right_in;
+            acc = *right_src++;
 
             // Diffuse through 4 allpasses.
             for (size_t i = 4; i < 8; i++) {
@@ -138,13 +148,13 @@ public:
                            lfo1_read_offset++) *
                     krt;
             }
-            processLPF(lp2_state, acc);
+            processLPF(lp2_state, acc, klp);
             processAPF(delays[11], acc, kap);
             processAPF(delays[12], acc, -kap);
             if constexpr (!std::is_empty<Processor>::value)
                 acc = processors[1]->process(acc);
 
-            processHPF(hp2_state, acc);
+            processHPF(hp2_state, acc, klp);
             delays[13]->write(acc);
 
             *right_out++ = *right_in + (acc - *right_in) * amount;
@@ -169,7 +179,18 @@ public:
     }
 
     void setDamping(float damping) {
-        this->damping = damping;
+        this->damping = Delays::scaleDamping(damping, delay_scale);
+    }
+
+    /**
+     * Frozen reverb ignores input and sustains its tail indefinitely
+     */
+    void setFreeze(bool freeze) {
+        frozen = freeze;
+    }
+
+    bool isFrozen() {
+        return frozen;
     }
 
     void clear() {
@@ -178,16 +199,23 @@ public:
         }
     }
 
+    /**
+     * Set modulation offsets and amounts in samples at sample rate of the
+     * delay table
+     */
     void setModulation(size_t offset1, size_t amount1, size_t offset2, size_t amount2) {
-        lfo_offset1 = offset1;
-        lfo_amount1 = amount1 / 2;
-        lfo_offset2 = offset2;
-        lfo_amount2 = amount2 / 2;
+        lfo_offset1 = Delays::scale(offset1, delay_scale);
+        lfo_amount1 = (amount1 / 2) * delay_scale;
+        lfo_offset2 = Delays::scale(offset2, delay_scale);
+        lfo_amount2 = (amount2 / 2) * delay_scale;
     }
 
     template <typename... Args>
     static DattorroStereoReverb* create(size_t block_size, float sr,
-        const size_t* delay_lengths, Args&&... args) {
+        const Delays& delay_table, Args&&... args) {
+        size_t delay_lengths[num_delays];
+        delay_table.scale(sr, delay_lengths);
+        float delay_scale = delay_table.getScale(sr);
         DelayBuffer** delays = new DelayBuffer*[num_delays];
         for (size_t i = 0; i < num_delays; i++) {
             delays[i] = DelayBuffer::create(delay_lengths[i]);
@@ -198,13 +226,15 @@ public:
         FloatArray tmp = FloatArray::create(block_size);
 
         if constexpr (std::is_empty<Processor>::value) {
-            return new DattorroStereoReverb(tmp, delays, lfo1, lfo2, nullptr);
+            return new DattorroStereoReverb(
+                tmp, delays, lfo1, lfo2, delay_scale, nullptr);
         }
         else {
             Processor** processors = new Processor*[2];
             processors[0] = Processor::create(std::forward<Args>(args)...);
             processors[1] = Processor::create(std::forward<Args>(args)...);
-            return new DattorroStereoReverb(tmp, delays, lfo1, lfo2, processors);
+            return new DattorroStereoReverb(
+                tmp, delays, lfo1, lfo2, delay_scale, processors);
         }
     }
 
@@ -235,16 +265,19 @@ protected:
     float lp1_state, lp2_state;
     float hp1_state, hp2_state, hpf_amount;
     size_t lfo_offset1, lfo_offset2;
-    size_t lfo_amount1, lfo_amount2;
+    float lfo_amount1, lfo_amount2;
+    float delay_scale;
+    size_t smear_offset;
+    bool frozen;
     FloatArray tmp;
 
-    inline void processLPF(float& state, float& value) {
-        state += damping * (value - state);
+    inline void processLPF(float& state, float& value, float klp) {
+        state += klp * (value - state);
         value = state;
     }
 
-    inline void processHPF(float& state, float& value) {
-        state += damping * (value - state);
+    inline void processHPF(float& state, float& value, float klp) {
+        state += klp * (value - state);
         value = state;
     }
 
@@ -258,7 +291,7 @@ protected:
 };
 
 // Rings, elements - has longer tails. Second diffuser APF chain delays are improvised.
-const size_t rings_delays[] = {
+const ReverbDelays<14> rings_delays = { 48000, {
     150,
     214,
     319,
@@ -273,10 +306,10 @@ const size_t rings_delays[] = {
     2525,
     2197,
     6312,
-};
+} };
 // Tank delays from nephologic classic, diffuser values replaced with
 // stereo diffuser from the same module
-const size_t clouds_delays[] = {
+const ReverbDelays<14> clouds_delays = { 48000, {
     126,
     180,
     269,
@@ -291,5 +324,5 @@ const size_t clouds_delays[] = {
     1913,
     1663,
     4782,
-};
+} };
 #endif
@@ -5,21 +5,41 @@
 //#undef max
 //#undef abs
 //#undef rand
-//#include <algorithm>
+#include <algorithm>
+#include "Interpolator.h"
 
-template <typename T, unsigned int max_delay>
+/**
+ * Smallest power of two that is not less than value
+ */
+static constexpr unsigned int nextPowerOfTwo(unsigned int value) {
+  unsigned int result = 1;
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+/**
+ * Circular delay line.
+ *
+ * If masked is true, capacity is rounded up to a power of two and indices are
+ * wrapped with a bitmask instead of modulo. This costs some extra memory, but
+ * avoids division on every access. See also PowerOfTwoDelayLine alias.
+ */
+template <typename T, unsigned int max_delay, bool masked = false>
 class DelayLine {
 public:
+  static constexpr unsigned int capacity = masked ? nextPowerOfTwo(max_delay) : max_delay;
+
   DelayLine() {};
 
-  DelayLine(T* buffer) : buffer(buffer) {
+  DelayLine(T* buffer) : buffer(buffer), writeIndex(0) {
   };
 
   /**
    * delay line can allocate memory instead of using preallocated buffer
    */
   static DelayLine create() {
-    auto buffer = new T[max_delay];
+    auto buffer = new T[capacity]();
     return DelayLine(buffer);
   }
 
@@ -31,7 +51,7 @@ public:
   }
 
   void reset() {
-    std::fill(&buffer[0], &buffer[max_delay], T(0));
+    std::fill(&buffer[0], &buffer[capacity], T(0));
     writeIndex = 0;
   }
 
@@ -40,14 +60,42 @@ public:
    */
   inline void write(const T value) {
     buffer[writeIndex] = value;
-    writeIndex = (writeIndex - 1 + max_delay) % max_delay;
+    writeIndex = wrap(writeIndex - 1);
+  }
+
+  /**
+   * write a block of samples, same as calling write() for each of them.
+   * Data is copied in at most two contiguous spans.
+   */
+  void write(const T* src, size_t size) {
+    size_t first = std::min<size_t>(size, writeIndex + 1);
+    // Buffer is filled backwards, so every span is copied in reverse order
+    std::reverse_copy(src, src + first, buffer + writeIndex + 1 - first);
+    if (first < size)
+      std::reverse_copy(src + first, src + size, buffer + capacity - (size - first));
+    writeIndex = wrap(writeIndex - size);
   }
 
   /**
    * read the value @param index steps back from the head of the circular buffer
    */
   inline const T read(int index) {
-    return buffer[(writeIndex + index + max_delay) % max_delay];
+    return buffer[wrap(writeIndex + index)];
+  }
+
+  /**
+   * read a block of the last @param size written samples delayed by
+   * @param delay steps, oldest sample first. With zero delay this returns
+   * the block that was just written. Data is copied in at most two
+   * contiguous spans.
+   */
+  void read(T* dst, size_t size, int delay) {
+    // Position of the oldest sample, later samples are stored at lower indices
+    unsigned int start = wrap(writeIndex + delay + size);
+    size_t first = std::min<size_t>(size, start + 1);
+    std::reverse_copy(buffer + start + 1 - first, buffer + start + 1, dst);
+    if (first < size)
+      std::reverse_copy(buffer + capacity - (size - first), buffer + capacity, dst + first);
   }
 
   /**
@@ -67,11 +115,11 @@ public:
   inline const T interpolateHermite(float index) {
     int idx = (int)index;
     float frac = index - idx;
-    int32_t t = (writeIndex + idx + max_delay);
-    const T xm1 = buffer[(t - 1) % max_delay];
-    const T x0 = buffer[(t) % max_delay];
-    const T x1 = buffer[(t + 1) % max_delay];
-    const T x2 = buffer[(t + 2) % max_delay];
+    int32_t t = (writeIndex + idx);
+    const T xm1 = buffer[wrap(t - 1)];
+    const T x0 = buffer[wrap(t)];
+    const T x1 = buffer[wrap(t + 1)];
+    const T x2 = buffer[wrap(t + 2)];
     const float c = (x1 - xm1) * 0.5f;
     const float v = x0 - x1;
     const float w = c + v;
@@ -81,6 +129,49 @@ public:
     return (((a * f) - b_neg) * f + c) * f + x0;    
   }
 
+  /**
+   * Read a block of fractionally delayed samples, one delay value per sample.
+   * Delays are relative to the last @param size written samples, like in
+   * block read(), so this is equivalent to calling interpolate() or
+   * interpolateHermite() with index (delays[i] + size - i).
+   *
+   * Supported interpolation methods are LINEAR_INTERPOLATION and HERMITE_INTERPOLATION.
+   */
+  template <InterpolationMethod im = LINEAR_INTERPOLATION>
+  void read(T* output, size_t size, const float* delays) {
+    render<im>(output, size, [delays](size_t i) { return delays[i]; });
+  }
+
+  /**
+   * Read a block of fractionally delayed samples with delay linearly
+   * ramped from @param start to @param end over the block
+   */
+  template <InterpolationMethod im = LINEAR_INTERPOLATION>
+  void read(T* output, size_t size, float start, float end) {
+    float incr = (end - start) / size;
+    render<im>(output, size, [start, incr](size_t i) { return start + incr * i; });
+  }
+
+  /**
+   * Read multiple taps for a block, @param delays contains an array of
+   * per-sample delays for each tap
+   */
+  template <InterpolationMethod im = LINEAR_INTERPOLATION>
+  void readTaps(T* const* outputs, const float* const* delays, size_t taps, size_t size) {
+    for (size_t tap = 0; tap < taps; tap++)
+      read<im>(outputs[tap], size, delays[tap]);
+  }
+
+  /**
+   * Read multiple taps for a block, each with delay ramped from
+   * starts[tap] to ends[tap]
+   */
+  template <InterpolationMethod im = LINEAR_INTERPOLATION>
+  void readTaps(T* const* outputs, const float* starts, const float* ends, size_t taps, size_t size) {
+    for (size_t tap = 0; tap < taps; tap++)
+      read<im>(outputs[tap], size, starts[tap], ends[tap]);
+  }
+
   inline const T allpass(const T value, int delay, const T coefficient) {
     T read_value = read(delay);
     T write_value = value + coefficient * read_value;
@@ -103,15 +194,80 @@ public:
   }
 
   /**
-   * get the capacity of the circular buffer
+   * get the capacity of the circular buffer, this may exceed max_delay
+   * for masked delay line
    */
   inline const unsigned int getSize() {
-    return max_delay;
+    return capacity;
   }
 
 private:
   T* buffer;  
   unsigned int writeIndex;
+
+  /**
+   * Interpolation kernel shared by all block reads. Positions are computed
+   * for a chunk of samples first, then samples are fetched and interpolated
+   * in a separate loop. Both loops are branch free, so that compiler can
+   * vectorize them where target supports it.
+   */
+  template <InterpolationMethod im, typename Delay>
+  void render(T* output, size_t size, Delay delay) {
+    static_assert(im == LINEAR_INTERPOLATION || im == HERMITE_INTERPOLATION,
+      "Unsupported interpolation method");
+    static constexpr size_t chunk_size = 16;
+    int indices[chunk_size];
+    float fractions[chunk_size];
+    for (size_t offset = 0; offset < size; offset += chunk_size) {
+      size_t len = std::min(chunk_size, size - offset);
+      for (size_t i = 0; i < len; i++) {
+        float position = delay(offset + i) + float(size - offset - i);
+        int idx = (int)position;
+        fractions[i] = position - idx;
+        indices[i] = writeIndex + idx;
+      }
+      T* out = output + offset;
+      if constexpr (im == HERMITE_INTERPOLATION) {
+        for (size_t i = 0; i < len; i++) {
+          int t = indices[i];
+          const T xm1 = buffer[wrap(t - 1)];
+          const T x0 = buffer[wrap(t)];
+          const T x1 = buffer[wrap(t + 1)];
+          const T x2 = buffer[wrap(t + 2)];
+          const float c = (x1 - xm1) * 0.5f;
+          const float v = x0 - x1;
+          const float w = c + v;
+          const float a = w + v + (x2 - x0) * 0.5f;
+          const float b_neg = w + a;
+          const float f = fractions[i];
+          out[i] = (((a * f) - b_neg) * f + c) * f + x0;
+        }
+      }
+      else {
+        for (size_t i = 0; i < len; i++) {
+          const T low = buffer[wrap(indices[i])];
+          const T high = buffer[wrap(indices[i] + 1)];
+          out[i] = low + (high - low) * fractions[i];
+        }
+      }
+    }
+  }
+
+  /**
+   * Wrap index that may be up to capacity steps out of range
+   */
+  static inline unsigned int wrap(int index) {
+    if constexpr (masked)
+      return index & (capacity - 1);
+    else
+      return (index + capacity) % capacity;
+  }
 };
 
+/**
+ * Delay line with bitmask index wrapping
+ */
+template <typename T, unsigned int max_delay>
+using PowerOfTwoDelayLine = DelayLine<T, max_delay, true>;
+
 #endif // __DelayLine_hpp__
@@ -2,6 +2,8 @@
 #define __DISCRETE_SUMMATION_OSCILLATOR_HPP__
 
 #include "ComplexOscillator.h"
+#include "LinearRamp.hpp"
+#include "FastTrig.hpp"
 
 enum DSFShape {
     DSF1,
@@ -21,10 +23,17 @@ enum DSFShape {
  * DSF2: infinite series, one-sided spectrum (-b != b)
  * DSF3: finite series, two-sided spectrum (-b == b)
  * DSF4: infinite series, two-sided spectrum (-b == b)
+ *
+ * With use_phasor enabled, partials are rendered by rotating phasors instead
+ * of calling trig functions per sample. This is much cheaper on devices
+ * without fast trig. Phasors are kept between calls and only set up again
+ * when frequency, b or n change, so rendering one sample at a time is cheap
+ * too.
  **/
-template <DSFShape shape>
+template <DSFShape shape, bool use_phasor = false>
 class DiscreteSummationOscillator
-    : public ComplexOscillatorTemplate<DiscreteSummationOscillator<shape>> {
+    : public ComplexOscillatorTemplate<
+          DiscreteSummationOscillator<shape, use_phasor>> {
 public:
     static constexpr float begin_phase = 0.f;
     static constexpr float end_phase = M_PI * 2;
@@ -36,7 +45,11 @@ public:
         , incr(0)
         , last_x(0)
         , last_y(0)
-        , ComplexOscillatorTemplate<DiscreteSummationOscillator<shape>>() {
+        , an(0)
+        , gain(0)
+        , phasors_valid(false)
+        , ComplexOscillatorTemplate<
+              DiscreteSummationOscillator<shape, use_phasor>>() {
     }
     DiscreteSummationOscillator(float freq, float sr)
         : DiscreteSummationOscillator() {
@@ -55,10 +68,16 @@ public:
         return (2 * M_PI) / mul;
     }
     void setFrequency(float freq) {
-        incr = freq * mul;
+        incr.set(freq * mul);
+    }
+    /**
+     * Ramp frequency over next rendered block
+     */
+    void rampFrequency(float freq) {
+        incr.ramp(freq * mul);
     }
     float getFrequency() {
-        return incr / mul;
+        return incr.getEnd() / mul;
     }
     void setPhase(float ph) {
         phase = ph;
@@ -69,16 +88,30 @@ public:
 
     void setA(float a) {
         this->a = a;
+        updateGain();
     }
     void setB(float b) {
-        this->b = b;
+        this->b.set(b);
+    }
+    void rampB(float b) {
+        this->b.ramp(b);
     }
     void setN(float n) {
         this->n = n;
+        updateGain();
+        phasors_valid = false;
     }
 
     void setFeedback(float magnitude, float phase) {
-        feedback.setPolar(magnitude, phase);
+        feedback_re.set(magnitude * cosf(phase));
+        feedback_im.set(magnitude * sinf(phase));
+    }
+    /**
+     * Ramp feedback over next rendered block
+     */
+    void rampFeedback(float magnitude, float phase) {
+        feedback_re.ramp(magnitude * cosf(phase));
+        feedback_im.ramp(magnitude * sinf(phase));
     }
 
     ComplexFloat getSample();
@@ -102,20 +135,175 @@ public:
 
 protected:
     float mul;
-    float incr;
+    LinearRamp<float> incr;
     float phase;
     float modPhase;
-    float a, b, n;
-    ComplexFloat feedback;
+    // Only b is ramped, constants derived from a and n are computed once
+    // per block
+    float a, n;
+    LinearRamp<float> b;
+    LinearRamp<float> feedback_re, feedback_im;
     float last_x, last_y;
+    // Phasor mode state: rotations by modulator phase s and n * s, and by
+    // their per sample increments for modulator increment phasor_ds
+    float an, gain;
+    ComplexFloat w1, wn, r1, rn;
+    float phasor_ds;
+    bool phasors_valid;
+
+    template <bool with_fm>
+    void render(size_t size, float* fm, ComplexFloat* out) {
+        if constexpr (use_phasor)
+            renderPhasor<with_fm>(size, fm, out);
+        else
+            renderTrig<with_fm>(size, fm, out);
+    }
+
+    template <bool with_fm>
+    void renderTrig(size_t size, float* fm, ComplexFloat* out);
+
+    static ComplexFloat rotation(float angle) {
+        return { cosf(angle), sinf(angle) };
+    }
+
+    /**
+     * Pull phasor back to unit circle, first order approximation of
+     * 1 / |z| is enough as it's applied on every sample
+     */
+    static ComplexFloat normalize(ComplexFloat z) {
+        float k = 1.5f - 0.5f * (z.re * z.re + z.im * z.im);
+        return { z.re * k, z.im * k };
+    }
+
+    void updateGain() {
+        if constexpr (!use_phasor)
+            return;
+        if constexpr (shape == DSF1) {
+            an = powf(a, n + 1.f);
+            gain = (a - 1.f) / (an - 1.f);
+        }
+        else if constexpr (shape == DSF2) {
+            gain = 1.f - a;
+        }
+        else if constexpr (shape == DSF3) {
+            an = powf(a, n + 1.f);
+            gain = (a - 1.f) / (2 * an - a - 1.f);
+        }
+        else {
+            gain = (1.f - a) * (1.f - a * a) / (1.f + a);
+        }
+    }
 
+    /**
+     * All formulas are evaluated as gain * (e^(i*phase) * Z) / D, where Z
+     * and D depend only on modulator phase s. Phasors for s and n * s are
+     * renormalized on every sample, as D is very sensitive to magnitude
+     * errors when a is close to 1. They are set up from modPhase again
+     * after n or modulator increment changes, or after a ramp.
+     * Carrier phase is offset by feedback and FM on every sample, so it
+     * uses polynomial trig instead.
+     */
     template <bool with_fm>
-    void render(size_t size, float* fm, ComplexFloat* out);
+    void renderPhasor(size_t size, float* fm, ComplexFloat* out) {
+        constexpr float inv_turn = 1 / (2 * M_PI);
+        constexpr bool finite = shape == DSF1 || shape == DSF3;
+        const float a2 = 1.f + a * a;
+        const float a3 = 2.f * a;
+
+        float inc = incr.getStart();
+        const float inc_step = incr.getStep(size);
+        float fb_re = feedback_re.getStart();
+        const float fb_re_step = feedback_re.getStep(size);
+        float fb_im = feedback_im.getStart();
+        const float fb_im_step = feedback_im.getStep(size);
+        // Modulator increment is ramped linearly, rotation by it is
+        // ramped by rotating it on every sample
+        float ds = b.getStart() * incr.getStart();
+        const float ds_step = (b.getEnd() * incr.getEnd() - ds) / size;
+        float s = modPhase;
+        if (!phasors_valid || ds != phasor_ds) {
+            w1 = rotation(s);
+            r1 = rotation(ds);
+            if constexpr (finite) {
+                wn = rotation(n * s);
+                rn = rotation(n * ds);
+            }
+            phasor_ds = ds;
+            phasors_valid = true;
+        }
+        ComplexFloat dr1 { 1.f, 0.f }, drn { 1.f, 0.f };
+        if (ds_step != 0.f) {
+            dr1 = rotation(ds_step);
+            if constexpr (finite)
+                drn = rotation(n * ds_step);
+            // Rotations accumulate rounding errors while ramping, so they
+            // are set up again for the next block
+            phasors_valid = false;
+        }
+        ComplexFloat w1 = this->w1, wn = this->wn;
+        ComplexFloat r1 = this->r1, rn = this->rn;
+        float _last_x = last_x;
+        float _last_y = last_y;
+        while (size--) {
+            inc += inc_step;
+            fb_re += fb_re_step;
+            fb_im += fb_im_step;
+            r1 = r1 * dr1;
+            float phase_re = (phase + _last_x * fb_re) * inv_turn;
+            float phase_im = (phase + _last_y * fb_im) * inv_turn;
+            if constexpr (with_fm) {
+                phase_re += *fm;
+                phase_im += *fm++;
+            }
+            float b1 = gain / (a2 - a3 * w1.re);
+            if constexpr (shape == DSF4) {
+                _last_x = FastTrig::cos(phase_re) * b1;
+                _last_y = FastTrig::sin(phase_im) * b1;
+            }
+            else {
+                // Z = 1 - a * e^(-i*s) for infinite series
+                ComplexFloat z { 1.f - a * w1.re, a * w1.im };
+                if constexpr (finite) {
+                    // Z -= a^(n+1) * e^(i*n*s) * (e^(i*s) - a)
+                    ComplexFloat tail = wn * ComplexFloat { w1.re - a, w1.im };
+                    z.re -= an * tail.re;
+                    z.im -= an * tail.im;
+                    rn = rn * drn;
+                    wn = normalize(wn * rn);
+                }
+                _last_x = (FastTrig::cos(phase_re) * z.re -
+                              FastTrig::sin(phase_re) * z.im) *
+                    b1;
+                _last_y = (FastTrig::sin(phase_im) * z.re +
+                              FastTrig::cos(phase_im) * z.im) *
+                    b1;
+            }
+            out->re = _last_x;
+            out->im = _last_y;
+            out++;
+            phase += inc;
+            ds += ds_step;
+            s += ds;
+            w1 = normalize(w1 * r1);
+        }
+        phase = fmodf(phase, M_PI * 2.f);
+        modPhase = fmodf(s, M_PI * 2.f);
+        this->w1 = w1;
+        this->wn = wn;
+        this->r1 = r1;
+        this->rn = rn;
+        last_x = _last_x;
+        last_y = _last_y;
+        incr.finish();
+        b.finish();
+        feedback_re.finish();
+        feedback_im.finish();
+    }
 };
 
 template <>
 template <bool with_fm>
-void DiscreteSummationOscillator<DSF1>::render(
+void DiscreteSummationOscillator<DSF1>::renderTrig(
     size_t size, float* fm, ComplexFloat* out) {
     float a1 = powf(a, n + 1.f);
     float a2 = n + 1.f;
@@ -125,35 +313,54 @@ void DiscreteSummationOscillator<DSF1>::render(
     float s = modPhase;
     float _last_x = last_x;
     float _last_y = last_y;
+    float inc = incr.getStart();
+    const float inc_step = incr.getStep(size);
+    float ratio = b.getStart();
+    const float ratio_step = b.getStep(size);
+    float fb_re = feedback_re.getStart();
+    const float fb_re_step = feedback_re.getStep(size);
+    float fb_im = feedback_im.getStart();
+    const float fb_im_step = feedback_im.getStep(size);
     while (size--) {
-        float phase_re = phase + _last_x * feedback.re;
-        float phase_im = phase + _last_y * feedback.im;
+        inc += inc_step;
+        ratio += ratio_step;
+        fb_re += fb_re_step;
+        fb_im += fb_im_step;
+        float phase_re = phase + _last_x * fb_re;
+        float phase_im = phase + _last_y * fb_im;
         if (with_fm) {
             float fm_mod = M_PI * 2.f * *fm++;
             phase_re += fm_mod;
             phase_im += fm_mod;
         }
-        out->re = gain *
+        float b1 = 1.f / (a3 - a4 * cos(s));
+        _last_x = gain *
             (cos(phase_re) - a * cos(phase_re - s) -
-                a1 * (cos(phase_re + s * a2) - a * cos(phase_re + n * s))) /
-            (a3 - a4 * cos(s));
-        out->im = gain *
+                a1 * (cos(phase_re + s * a2) - a * cos(phase_re + n * s))) *
+            b1;
+        out->re = _last_x;
+        _last_y = gain *
             (sin(phase_im) - a * sin(phase_im - s) -
-                a1 * (sin(phase_im + s * a2) - a * sin(phase_im + n * s))) /
-            (a3 - a4 * cos(s));
+                a1 * (sin(phase_im + s * a2) - a * sin(phase_im + n * s))) *
+            b1;
+        out->im = _last_y;
         out++;
-        phase += incr;
-        s += b * incr;
+        phase += inc;
+        s += ratio * inc;
     }
     phase = fmodf(phase, M_PI * 2.f);
     modPhase = fmodf(s, M_PI * 2.f);
     last_x = _last_x;
     last_y = _last_y;
+    incr.finish();
+    b.finish();
+    feedback_re.finish();
+    feedback_im.finish();
 }
 
 template <>
 template <bool with_fm>
-void DiscreteSummationOscillator<DSF2>::render(
+void DiscreteSummationOscillator<DSF2>::renderTrig(
     size_t size, float* fm, ComplexFloat* out) {
     float a1 = (1.f + a * a);
     float a2 = 2.f * a;
@@ -161,9 +368,21 @@ void DiscreteSummationOscillator<DSF2>::render(
     float s = modPhase;
     float _last_x = last_x;
     float _last_y = last_y;
+    float inc = incr.getStart();
+    const float inc_step = incr.getStep(size);
+    float ratio = b.getStart();
+    const float ratio_step = b.getStep(size);
+    float fb_re = feedback_re.getStart();
+    const float fb_re_step = feedback_re.getStep(size);
+    float fb_im = feedback_im.getStart();
+    const float fb_im_step = feedback_im.getStep(size);
     while (size--) {
-        float phase_re = phase + _last_x * feedback.re;
-        float phase_im = phase + _last_y * feedback.im;
+        inc += inc_step;
+        ratio += ratio_step;
+        fb_re += fb_re_step;
+        fb_im += fb_im_step;
+        float phase_re = phase + _last_x * fb_re;
+        float phase_im = phase + _last_y * fb_im;
         if (with_fm) {
             float fm_mod = M_PI * 2.f * *fm++;
             phase_re += fm_mod;
@@ -176,18 +395,22 @@ void DiscreteSummationOscillator<DSF2>::render(
             gain * (sin(phase_im) - a * sin(phase_im - s)) / (a1 - a2 * cos(s));
         out->im = _last_y;
         out++;
-        phase += incr;
-        s += b * incr;
+        phase += inc;
+        s += ratio * inc;
     }
     phase = fmodf(phase, M_PI * 2.f);
     modPhase = fmodf(s, M_PI * 2.f);
     last_x = _last_x;
     last_y = _last_y;
+    incr.finish();
+    b.finish();
+    feedback_re.finish();
+    feedback_im.finish();
 }
 
 template <>
 template <bool with_fm>
-void DiscreteSummationOscillator<DSF3>::render(
+void DiscreteSummationOscillator<DSF3>::renderTrig(
     size_t size, float* fm, ComplexFloat* out) {
     float a1 = powf(a, n + 1.f);
     float a2 = n + 1.f;
@@ -197,9 +420,21 @@ void DiscreteSummationOscillator<DSF3>::render(
     float s = modPhase;
     float _last_x = last_x;
     float _last_y = last_y;
+    float inc = incr.getStart();
+    const float inc_step = incr.getStep(size);
+    float ratio = b.getStart();
+    const float ratio_step = b.getStep(size);
+    float fb_re = feedback_re.getStart();
+    const float fb_re_step = feedback_re.getStep(size);
+    float fb_im = feedback_im.getStart();
+    const float fb_im_step = feedback_im.getStep(size);
     while (size--) {
-        float phase_re = phase + _last_x * feedback.re;
-        float phase_im = phase + _last_y * feedback.im;
+        inc += inc_step;
+        ratio += ratio_step;
+        fb_re += fb_re_step;
+        fb_im += fb_im_step;
+        float phase_re = phase + _last_x * fb_re;
+        float phase_im = phase + _last_y * fb_im;
         if (with_fm) {
             float fm_mod = M_PI * 2.f * *fm++;
             phase_re += fm_mod;
@@ -217,18 +452,22 @@ void DiscreteSummationOscillator<DSF3>::render(
             b1;
         out->im = _last_y;
         out++;
-        phase += incr;
-        s += b * incr;
+        phase += inc;
+        s += ratio * inc;
     }
     phase = fmodf(phase, M_PI * 2.f);
     modPhase = fmodf(s, M_PI * 2.f);
     last_x = _last_x;
     last_y = _last_y;
+    incr.finish();
+    b.finish();
+    feedback_re.finish();
+    feedback_im.finish();
 }
 
 template <>
 template <bool with_fm>
-void DiscreteSummationOscillator<DSF4>::render(
+void DiscreteSummationOscillator<DSF4>::renderTrig(
     size_t size, float* fm, ComplexFloat* out) {
     float a1 = 1.f - a * a;
     float a2 = 1.f + a * a;
@@ -237,9 +476,21 @@ void DiscreteSummationOscillator<DSF4>::render(
     float s = modPhase;
     float _last_x = last_x;
     float _last_y = last_y;
+    float inc = incr.getStart();
+    const float inc_step = incr.getStep(size);
+    float ratio = b.getStart();
+    const float ratio_step = b.getStep(size);
+    float fb_re = feedback_re.getStart();
+    const float fb_re_step = feedback_re.getStep(size);
+    float fb_im = feedback_im.getStart();
+    const float fb_im_step = feedback_im.getStep(size);
     while (size--) {
-        float phase_re = phase + _last_x * feedback.re;
-        float phase_im = phase + _last_y * feedback.im;
+        inc += inc_step;
+        ratio += ratio_step;
+        fb_re += fb_re_step;
+        fb_im += fb_im_step;
+        float phase_re = phase + _last_x * fb_re;
+        float phase_im = phase + _last_y * fb_im;
         if (with_fm) {
             float fm_mod = M_PI * 2.f * *fm++;
             phase_re += fm_mod;
@@ -249,15 +500,19 @@ void DiscreteSummationOscillator<DSF4>::render(
         _last_x = gain * a1 * cos(phase_re) * b1;
         out->re = _last_x;
         _last_y = gain * a1 * sin(phase_im) * b1;
-        out->im = last_y;
+        out->im = _last_y;
         out++;
-        phase += incr;
-        s += b * incr;
+        phase += inc;
+        s += ratio * inc;
     }
     phase = fmodf(phase, M_PI * 2.f);
     modPhase = fmodf(s, M_PI * 2.f);
     last_x = _last_x;
     last_y = _last_y;
+    incr.finish();
+    b.finish();
+    feedback_re.finish();
+    feedback_im.finish();
 }
 
 #endif
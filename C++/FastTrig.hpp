@@ -0,0 +1,34 @@
+#ifndef __FAST_TRIG_HPP__
+#define __FAST_TRIG_HPP__
+
+#include "basicmaths.h"
+
+/**
+ * Polynomial sine and cosine of normalized phase, where 1.0 is a full turn.
+ *
+ * Any phase is accepted, it's wrapped to [-0.5..0.5] and folded to a
+ * quarter turn where Taylor series is accurate to about 1e-6. This is
+ * cheaper than library functions and has no tables.
+ */
+class FastTrig {
+public:
+    static float sin(float phase) {
+        float r = phase - floorf(phase + 0.5f);
+        r = r > 0.25f ? 0.5f - r : (r < -0.25f ? -0.5f - r : r);
+        float x = r * float(2 * M_PI);
+        float x2 = x * x;
+        // Horner scheme for x - x^3/3! + x^5/5! - ... - x^11/11!
+        float acc = -1.f / 39916800;
+        acc = acc * x2 + 1.f / 362880;
+        acc = acc * x2 - 1.f / 5040;
+        acc = acc * x2 + 1.f / 120;
+        acc = acc * x2 - 1.f / 6;
+        return x + x * x2 * acc;
+    }
+
+    static float cos(float phase) {
+        return sin(phase + 0.25f);
+    }
+};
+
+#endif
@@ -75,7 +75,7 @@ private:
     int centernote = 0;
     float fundamental;
     const float NYQUIST;
-    ComplexWeightedPolynomials<TONES>* shaper;
+    ComplexChebyshevSeries<TONES>* shaper;
 
 public:
     HarmonicQuadraturePatch()
@@ -96,7 +96,7 @@ public:
         registerParameter(PARAMETER_F, "Overflow>");
         registerParameter(PARAMETER_G, "Intensity>");
         osc = ComplexDomainOscillator::create(getSampleRate());
-        shaper = ComplexWeightedPolynomials<TONES>::create(getBlockSize());
+        shaper = ComplexChebyshevSeries<TONES>::create();
         for (int i = 0; i < TONES; i++) {
             registerParameter(PatchParameterId(PARAMETER_AA + i), names[i]);
             setParameterValue(PatchParameterId(PARAMETER_AA + i), 0.5);
@@ -109,7 +109,7 @@ public:
 
     ~HarmonicQuadraturePatch() {
         ComplexDomainOscillator::destroy(osc);
-        ComplexWeightedPolynomials<TONES>::destroy(shaper);
+        ComplexChebyshevSeries<TONES>::destroy(shaper);
         ComplexFloatArray::destroy(mix);
     }
 
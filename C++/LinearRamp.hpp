@@ -0,0 +1,62 @@
+#ifndef __LINEAR_RAMP_HPP__
+#define __LINEAR_RAMP_HPP__
+
+#include <stddef.h>
+
+/**
+ * Parameter that moves linearly from start to end value over a rendered
+ * block.
+ *
+ * Oscillators read start value and per sample step before their render
+ * loop and call finish() after it, so next block starts where the previous
+ * one ended. T must support subtraction and multiplication by float.
+ */
+template <typename T = float>
+class LinearRamp {
+public:
+    LinearRamp(T value = T())
+        : start(value)
+        , end(value) {
+    }
+
+    /**
+     * Jump to value without ramping
+     */
+    void set(T value) {
+        start = value;
+        end = value;
+    }
+
+    /**
+     * Ramp from value reached by previous block to given value
+     */
+    void ramp(T value) {
+        end = value;
+    }
+
+    void ramp(T from, T to) {
+        start = from;
+        end = to;
+    }
+
+    T getStart() const {
+        return start;
+    }
+
+    T getEnd() const {
+        return end;
+    }
+
+    T getStep(size_t size) const {
+        return (end - start) * (1.f / size);
+    }
+
+    void finish() {
+        start = end;
+    }
+
+private:
+    T start, end;
+};
+
+#endif
@@ -17,6 +17,13 @@ public:
         return (x > 0.0f) ? 1.0f : ((x < 0.0f) ? -1.0f : 0.0f);
         //        return (0.f < x) - (x < 0.f);
     }
+
+    /**
+     * Branchless sign for non-zero values, same as signum() away from 0
+     */
+    static float sign(float x) {
+        return copysignf(1.0f, x);
+    }
 };
 
 /**
@@ -46,28 +53,18 @@ public:
 class CubicSaturator : public Nonlinearity {
 public:
     static float getSample(float x) {
-        if (std::abs(x) >= 1.f)
-            return signum(x);
-        else
-            return x * (3.f - x * x) / 2;
+        return std::abs(x) >= 1.f ? sign(x) : x * (3.f - x * x) / 2;
     }
     static float getAntiderivative1(float x) {
         float a = std::abs(x);
-        if (a >= 1.f)
-            return a - 3.f / 8.f;
-        else {
-            float a = x * x;
-            return 3.f * a / 4 - a * a / 8;
-        }
+        float b = x * x;
+        return a >= 1.f ? a - 3.f / 8.f : 3.f * b / 4 - b * b / 8;
     }
     static float getAntiderivative2(float x) {
         float a = std::abs(x);
-        if (a >= 1.f)
-            return a * x / 2 - x * 3.f / 8.f + signum(x) / 10;
-        else {
-            float a = x * x;
-            return a * x / 4 - a * a * x / 40;
-        }
+        float b = x * x;
+        return a >= 1.f ? a * x / 2 - x * 3.f / 8.f + sign(x) / 10
+                        : b * x / 4 - b * b * x / 40;
     }
 };
 
@@ -77,24 +74,17 @@ public:
 class SecondOrderPolynomial : public Nonlinearity {
 public:
     static float getSample(float x) {
-        if (std::abs(x) > 1)
-            return signum(x);
-        else
-            return x * (2.f - std::abs(x));
+        float xabs = std::abs(x);
+        return xabs > 1 ? sign(x) : x * (2.f - xabs);
     }
     static float getAntiderivative1(float x) {
         float xabs = std::abs(x);
-        if (xabs > 1.f)
-            return xabs - 1.f / 3;
-        else
-            return x * x * (1.f - xabs / 3);
+        return xabs > 1.f ? xabs - 1.f / 3 : x * x * (1.f - xabs / 3);
     }
     static float getAntiderivative2(float x) {
         float xabs = std::abs(x);
-        if (xabs > 1.f)
-            return x * xabs / 2 - x / 3 + signum(x) / 12;
-        else
-            return x * x * x * (1.f / 3 - xabs / 12);
+        return xabs > 1.f ? x * xabs / 2 - x / 3 + sign(x) / 12
+                          : x * x * x * (1.f / 3 - xabs / 12);
     }
 };
 
@@ -104,58 +94,38 @@ public:
 class ThirdOrderPolynomial : public Nonlinearity {
 public:
     static float getSample(float x) {
-        if (std::abs(x) >= 1.5f)
-            return signum(x);
-        else
-            return x - x * x * x * 4 / 27;
+        return std::abs(x) >= 1.5f ? sign(x) : x - x * x * x * 4 / 27;
     }
     static float getAntiderivative1(float x) {
         float a = std::abs(x);
-        if (a >= 1.5f)
-            return a - 9.f / 16.f;
-        else {
-            float b = x * x;
-            return b / 2 - b * b / 27;
-        }
+        float b = x * x;
+        return a >= 1.5f ? a - 9.f / 16.f : b / 2 - b * b / 27;
     }
     static float getAntiderivative2(float x) {
         float a = std::abs(x);
-        if (a >= 1.5f)
-            return a * x / 2 - x * 9 / 16 + signum(x) * 36 / 160;
-        else {
-            float b = a * a;
-            return b * x / 6 - b * b * x / 135;
-        }
+        float b = a * a;
+        return a >= 1.5f ? a * x / 2 - x * 9 / 16 + sign(x) * 36 / 160
+                         : b * x / 6 - b * b * x / 135;
     }
 };
 
 class FourthOrderPolynomial : public Nonlinearity {
 public:
     static float getSample(float x) {
-        if (std::abs(x) >= 1.f)
-            return signum(x);
-        else {
-            return x * x * x * (4 - std::abs(x)) - x * std::abs(x) * 6 + x * 4;
-        }
+        float a = std::abs(x);
+        return a >= 1.f ? sign(x) : x * x * x * (4 - a) - x * a * 6 + x * 4;
     }
     static float getAntiderivative1(float x) {
         float a = std::abs(x);
-        if (a >= 1.f)
-            return a - 0.2f;
-        else {
-            float b = x * x;
-            float c = b * b;
-            return -a * c / 5 + c + b * 2 * (1.f - a);
-        }
+        float b = x * x;
+        float c = b * b;
+        return a >= 1.f ? a - 0.2f : -a * c / 5 + c + b * 2 * (1.f - a);
     }
     static float getAntiderivative2(float x) {
         float a = std::abs(x);
-        if (a >= 1.f)
-            return x * a / 2 - x / 5 + signum(x) / 30.f;
-        else {
-            float b = a * a;
-            return b * b * x * (-a / 30 + 1 / 5) + x * b * (-a / 2 + 2.f / 3);
-        }
+        float b = a * a;
+        return a >= 1.f ? x * a / 2 - x / 5 + sign(x) / 30.f
+                        : b * b * x * (-a / 30 + 1 / 5) + x * b * (-a / 2 + 2.f / 3);
     }
 };
 
@@ -218,23 +188,17 @@ public:
 class SineSaturator : public Nonlinearity {
 public:
     static float getSample(float x) {
-        if (std::abs(x) >= 1.f)
-            return signum(x);
-        else
-            return sinf(x * M_PI_2);
+        return std::abs(x) >= 1.f ? sign(x) : sinf(x * M_PI_2);
     }
     static float getAntiderivative1(float x) {
-        if (std::abs(x) >= 1.f)
-            return std::abs(x) - 1.f + M_2_PI;
-        else
-            return M_2_PI - M_2_PI * cosf(x * M_PI_2);
+        return std::abs(x) >= 1.f ? float(std::abs(x) - 1.f + M_2_PI)
+                                  : float(M_2_PI - M_2_PI * cosf(x * M_PI_2));
     }
     static float getAntiderivative2(float x) {
-        if (std::abs(x) >= 1.f)
-            return 0.5f * x * std::abs(x) - x + M_2_PI * x -
-                signum(x) * M_2_PI * M_2_PI + 0.5f * signum(x);
-        else
-            return M_2_PI * (x - M_2_PI * sin(M_PI_2 * x));
+        float a = std::abs(x);
+        return a >= 1.f ? float(0.5f * x * a - x + M_2_PI * x -
+                              sign(x) * M_2_PI * M_2_PI + 0.5f * sign(x))
+                        : float(M_2_PI * (x - M_2_PI * sin(M_PI_2 * x)));
     }
 };
 
@@ -245,26 +209,20 @@ public:
 class QuadraticSineSaturator : public Nonlinearity {
 public:
     static float getSample(float x) {
-        if (std::abs(x) >= 1)
-            return signum(x);
-        else {
-            float a = sin(M_PI_2 * x);
-            return std::abs(a) * a;
-        }
+        float a = sin(M_PI_2 * x);
+        return std::abs(x) >= 1 ? sign(x) : std::abs(a) * a;
     }
     static float getAntiderivative1(float x) {
-        if (std::abs(x) >= 1)
-            return std::abs(x) - 0.5f;
-        else {
-            return signum(x) * 0.5f * (x - sin(M_PI * x) / M_PI);
-        }
+        float a = std::abs(x);
+        return a >= 1 ? float(a - 0.5f)
+                      : float(sign(x) * 0.5f * (x - sin(M_PI * x) / M_PI));
     }
     static float getAntiderivative2(float x) {
-        if (std::abs(x) >= 1)
-            return x * std::abs(x) / 2 - x / 2 + signum(x) * (0.25 - 1.f / (M_PI * M_PI));
-        else {
-            return signum(x) / (M_PI * M_PI * 2) * (M_PI * M_PI * x * x / 2 + cos(M_PI * x) - 1.f);
-        }
+        float a = std::abs(x);
+        return a >= 1
+            ? float(x * a / 2 - x / 2 + sign(x) * (0.25 - 1.f / (M_PI * M_PI)))
+            : float(sign(x) / (M_PI * M_PI * 2) *
+                  (M_PI * M_PI * x * x / 2 + cos(M_PI * x) - 1.f));
     }
 };
 
@@ -274,28 +232,21 @@ public:
 class CubicSineSaturator : public Nonlinearity {
 public:
     static float getSample(float x) {
-        if (std::abs(x) >= 1)
-            return signum(x);
-        else {
-            float a = sin(M_PI_2 * x);
-            return a * a * a;
-        }
+        float a = sin(M_PI_2 * x);
+        return std::abs(x) >= 1 ? sign(x) : a * a * a;
     }
     static float getAntiderivative1(float x) {
-        if (std::abs(x) >= 1)
-            return std::abs(x) + -1.f + 4.f * M_PI / 3;
-        else {
-            float a = cos(M_PI_2 * x);
-            return M_2_PI / 3 * (a * a * a - a * 3 + 2.f);
-        }
+        float a = cos(M_PI_2 * x);
+        return std::abs(x) >= 1 ? float(std::abs(x) - 1.f + 4.f / (3 * M_PI))
+                                : float(M_2_PI / 3 * (a * a * a - a * 3 + 2.f));
     }
     static float getAntiderivative2(float x) {
-        if (std::abs(x) >= 1)
-            return x * std::abs(x) / 2 + x * (4.f - 3.f * M_PI) / M_PI / 3 - signum(x) * (0.5 - 28.f / 9 / M_PI / M_PI);
-        else {
-            float a = sin(M_PI_2 * x);
-            return -4.f / (M_PI  * M_PI * 9) * a * a * a - 8.f / (3 * M_PI * M_PI) * a + 4.f / (3 * M_PI) * x;
-        }
+        float a = sin(M_PI_2 * x);
+        return std::abs(x) >= 1
+            ? float(x * std::abs(x) / 2 + x * (4.f - 3.f * M_PI) / M_PI / 3 +
+                  sign(x) * (0.5 - 28.f / 9 / M_PI / M_PI))
+            : float(-4.f / (M_PI * M_PI * 9) * a * a * a -
+                  8.f / (3 * M_PI * M_PI) * a + 4.f / (3 * M_PI) * x);
     }
 };
 
@@ -306,24 +257,19 @@ public:
 class ReciprocalSaturator : public Nonlinearity {
 public:
     static float getSample(float x) {
-        if (std::abs(x) > 0.5f)
-            return signum(x) - 0.25 / x;
-        else
-            return x;
+        return std::abs(x) > 0.5f ? float(sign(x) - 0.25 / x) : x;
     }
     static float getAntiderivative1(float x) {
         float xabs = std::abs(x);
-        if (xabs > 0.5f)
-            return xabs - 0.25f * fast_logf(xabs) - 0.5f - M_LN2 / 4 + 0.125;
-        else
-            return x * x / 2;
+        return xabs > 0.5f
+            ? float(xabs - 0.25f * fast_logf(xabs) - 0.5f - M_LN2 / 4 + 0.125)
+            : x * x / 2;
     }
     static float getAntiderivative2(float x) {
         float xabs = std::abs(x);
-        if (xabs > 0.5f)
-            return x * xabs / 2 - x * fast_logf(xabs) / 4 - x * (1.f / 8 + M_LN2 / 4) - signum(x) / 24;
-        else
-            return x * x * x / 6;
+        return xabs > 0.5f ? float(x * xabs / 2 - x * fast_logf(xabs) / 4 -
+                                 x * (1.f / 8 + M_LN2 / 4) - sign(x) / 24)
+                           : x * x * x / 6;
     }
 };
 
@@ -370,10 +316,41 @@ public:
     float process(float input) override {
         return antialiasedClipN1(input);
     }
+    /**
+     * Block version of antialiasedClipN1() with identical output.
+     *
+     * Antiderivative is only computed for well-conditioned samples. After a
+     * run of ill-conditioned samples, it's computed for the previous sample
+     * again, so slowly changing input mostly costs one getSample() call per
+     * sample. Input and output may be the same array.
+     */
     void process(FloatArray input, FloatArray output) {
+        const float* in = input.getData();
+        float* out = output.getData();
+        float x = xn1;
+        float F = Fn1;
+        bool has_F = true;
         for (size_t i = 0; i < input.getSize(); i++) {
-            output[i] = this->antialiasedClipN1(input[i]);
+            float next = in[i];
+            float dx = next - x;
+            if (std::abs(dx) < thresh) {
+                out[i] = Function::getSample(0.5f * (next + x));
+                has_F = false;
+            }
+            else {
+                if (!has_F)
+                    F = Function::getAntiderivative1(x);
+                float F_next = Function::getAntiderivative1(next);
+                out[i] = (F_next - F) / dx;
+                F = F_next;
+                has_F = true;
+            }
+            x = next;
         }
+        if (!has_F)
+            F = Function::getAntiderivative1(x);
+        xn1 = x;
+        Fn1 = Fn = F;
     }
     float antialiasedClipN1(float x) {
         Fn = Function::getAntiderivative1(x);
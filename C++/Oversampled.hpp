@@ -0,0 +1,291 @@
+#ifndef __OVERSAMPLED_HPP__
+#define __OVERSAMPLED_HPP__
+
+#include <string.h>
+#include <type_traits>
+#include "FloatArray.h"
+#include "SignalProcessor.h"
+#include "message.h"
+
+/**
+ * Linear phase half-band lowpass with 4 * order - 1 taps, used for changing
+ * sample rate by 2.
+ *
+ * Every other tap of a half-band filter is zero and the center tap is 0.5,
+ * so each polyphase branch costs order multiply-adds and the other one is
+ * a plain delay. Only one side of symmetric coefficients is stored.
+ */
+class HalfBandFilter {
+public:
+    static constexpr size_t max_order = 16;
+
+    HalfBandFilter() = default;
+    HalfBandFilter(size_t order, FloatArray history)
+        : order(order)
+        , history(history) {
+        design();
+        history.clear();
+    }
+
+    size_t getOrder() const {
+        return order;
+    }
+
+    /**
+     * Number of history samples needed for processing size input samples
+     */
+    static size_t getHistorySize(size_t order, size_t size) {
+        return 2 * order + size;
+    }
+
+protected:
+    size_t order;
+    FloatArray history;
+    float coeffs[max_order];
+
+    /**
+     * Blackman windowed sinc, normalized for unity gain at DC. Coefficient
+     * j is used for taps at 2 * j + 1 samples from the center.
+     */
+    void design() {
+        float sum = 0;
+        for (size_t j = 0; j < order; j++) {
+            float d = 2 * j + 1;
+            float w = 0.42f + 0.5f * cosf(M_PI * d / (2 * order)) +
+                0.08f * cosf(2 * M_PI * d / (2 * order));
+            coeffs[j] = ((j & 1) ? -1 : 1) * w / (M_PI * d);
+            sum += coeffs[j];
+        }
+        for (size_t j = 0; j < order; j++) {
+            coeffs[j] *= 0.25f / sum;
+        }
+    }
+
+    /**
+     * Symmetric sum around x, where x[0] and x[1] are the samples closest to
+     * the center
+     */
+    inline float convolve(const float* x) const {
+        float acc = 0;
+        for (size_t j = 0; j < order; j++) {
+            acc += coeffs[j] * (x[1 + j] + x[-(int)j]);
+        }
+        return acc;
+    }
+
+    /**
+     * Keep last samples of a block as history for the next one
+     */
+    static void shift(float* data, size_t keep, size_t size) {
+        memmove(data, data + size, keep * sizeof(float));
+    }
+};
+
+/**
+ * Doubles sample rate of input. Output has twice the size of input, input
+ * and output may overlap.
+ */
+class HalfBandUpsampler : public HalfBandFilter {
+public:
+    using HalfBandFilter::HalfBandFilter;
+
+    void process(const float* input, float* output, size_t size) {
+        ASSERT(2 * order + size <= history.getSize(), "Block too large for upsampler");
+        // Input sample n is stored at 2 * order + n
+        float* x = history.getData();
+        memcpy(x + 2 * order, input, size * sizeof(float));
+        for (size_t n = 0; n < size; n++) {
+            const float* center = x + n + order;
+            *output++ = 2 * convolve(center);
+            *output++ = center[1];
+        }
+        shift(x, 2 * order, size);
+    }
+};
+
+/**
+ * Halves sample rate of input. Output has half the size of input, input and
+ * output may overlap.
+ */
+class HalfBandDownsampler : public HalfBandFilter {
+public:
+    HalfBandDownsampler() = default;
+    HalfBandDownsampler(size_t order, FloatArray history)
+        : HalfBandFilter(order, history)
+        , max_size(history.getSize() - 3 * order) {
+    }
+
+    /**
+     * History holds even samples followed by odd samples, their offsets are
+     * set by the largest block size
+     */
+    static size_t getHistorySize(size_t order, size_t size) {
+        return 3 * order + size;
+    }
+
+    /**
+     * Size must be even and not larger than the size history was made for
+     */
+    void process(const float* input, float* output, size_t size) {
+        ASSERT((size & 1) == 0 && size <= max_size, "Invalid downsampler block size");
+        // Even input samples are stored at 2 * order + n, odd ones are
+        // delayed by order samples to line up with the center tap
+        float* even = history.getData();
+        float* odd = even + 2 * order + max_size / 2;
+        for (size_t n = 0; n < size / 2; n++) {
+            even[2 * order + n] = input[2 * n];
+            odd[order + n] = input[2 * n + 1];
+        }
+        for (size_t n = 0; n < size / 2; n++) {
+            *output++ = convolve(even + n + order) + 0.5f * odd[n];
+        }
+        shift(even, 2 * order, size / 2);
+        shift(odd, order, size / 2);
+    }
+
+protected:
+    size_t max_size;
+};
+
+/**
+ * Runs Processor at factor times the sample rate by upsampling its input
+ * and downsampling its output with cascaded half-band stages, factor must
+ * be 2, 4 or 8.
+ *
+ * Processor can be a SignalProcessor or a MultiSignalProcessor with
+ * num_channels channels. It is constructed from arguments passed to
+ * create(), so it must not require its own create(). Filter state and the
+ * oversampled block are allocated from a single arena, so cost depends only
+ * on factor and order.
+ *
+ * Lower order makes filters cheaper at the expense of a wider transition
+ * band below Nyquist. Default order gives a 31 tap filter with about 70dB
+ * of image and alias rejection.
+ */
+template <typename Processor, size_t factor, size_t num_channels = 1,
+    size_t order = 8>
+class Oversampled : public Processor {
+private:
+    static_assert(factor == 2 || factor == 4 || factor == 8,
+        "Oversampling factor must be 2, 4 or 8");
+    static_assert(order <= HalfBandFilter::max_order, "Filter order too high");
+    static constexpr size_t num_stages = factor == 2 ? 1 : (factor == 4 ? 2 : 3);
+    static constexpr bool is_multi =
+        std::is_base_of<MultiSignalProcessor, Processor>::value;
+
+public:
+    template <typename... Args>
+    Oversampled(FloatArray arena, AudioBuffer* buffer, size_t block_size,
+        Args&&... args)
+        : Processor(std::forward<Args>(args)...)
+        , arena(arena)
+        , buffer(buffer) {
+        float* data = arena.getData();
+        for (size_t ch = 0; ch < num_channels; ch++) {
+            size_t size = block_size;
+            for (size_t i = 0; i < num_stages; i++) {
+                size_t up_size = HalfBandUpsampler::getHistorySize(order, size);
+                size_t down_size =
+                    HalfBandDownsampler::getHistorySize(order, size * 2);
+                upsamplers[ch][i] =
+                    HalfBandUpsampler(order, FloatArray(data, up_size));
+                data += up_size;
+                downsamplers[ch][i] =
+                    HalfBandDownsampler(order, FloatArray(data, down_size));
+                data += down_size;
+                size *= 2;
+            }
+            if constexpr (!is_multi) {
+                samples[ch] = FloatArray(data, size);
+                data += size;
+            }
+        }
+    }
+
+    void process(FloatArray input, FloatArray output) {
+        size_t size = input.getSize();
+        FloatArray oversampled = samples[0].subArray(0, size * factor);
+        upsample(0, input, oversampled);
+        Processor::process(oversampled, oversampled);
+        downsample(0, oversampled, output);
+    }
+
+    void process(AudioBuffer& input, AudioBuffer& output) {
+        size_t size = input.getSize();
+        for (size_t ch = 0; ch < num_channels; ch++) {
+            upsample(ch, input.getSamples(ch), buffer->getSamples(ch));
+        }
+        Processor::process(*buffer, *buffer);
+        for (size_t ch = 0; ch < num_channels; ch++) {
+            downsample(ch, buffer->getSamples(ch).subArray(0, size * factor),
+                output.getSamples(ch));
+        }
+    }
+
+    /**
+     * Samples of delay added by resampling at original sample rate
+     */
+    static constexpr float getLatency() {
+        return 2 * (2 * order - 1) * (1 - 1.0f / factor);
+    }
+
+    template <typename... Args>
+    static Oversampled* create(size_t block_size, Args&&... args) {
+        size_t arena_size = 0;
+        for (size_t ch = 0; ch < num_channels; ch++) {
+            size_t size = block_size;
+            for (size_t i = 0; i < num_stages; i++) {
+                arena_size += HalfBandUpsampler::getHistorySize(order, size);
+                arena_size += HalfBandDownsampler::getHistorySize(order, size * 2);
+                size *= 2;
+            }
+            if constexpr (!is_multi)
+                arena_size += size;
+        }
+        AudioBuffer* buffer = nullptr;
+        if constexpr (is_multi)
+            buffer = AudioBuffer::create(num_channels, block_size * factor);
+        return new Oversampled(FloatArray::create(arena_size), buffer,
+            block_size, std::forward<Args>(args)...);
+    }
+
+    static void destroy(Oversampled* processor) {
+        FloatArray::destroy(processor->arena);
+        if constexpr (is_multi)
+            AudioBuffer::destroy(processor->buffer);
+        delete processor;
+    }
+
+protected:
+    FloatArray arena;
+    AudioBuffer* buffer;
+    FloatArray samples[num_channels];
+    HalfBandUpsampler upsamplers[num_channels][num_stages];
+    HalfBandDownsampler downsamplers[num_channels][num_stages];
+
+    /**
+     * Output is used as scratch space for intermediate stages
+     */
+    void upsample(size_t ch, FloatArray input, FloatArray output) {
+        size_t size = input.getSize();
+        const float* src = input.getData();
+        float* dst = output.getData();
+        for (size_t i = 0; i < num_stages; i++) {
+            upsamplers[ch][i].process(src, dst, size);
+            src = dst;
+            size *= 2;
+        }
+    }
+
+    void downsample(size_t ch, FloatArray input, FloatArray output) {
+        size_t size = input.getSize();
+        float* data = input.getData();
+        for (size_t i = num_stages; i > 1; i--) {
+            downsamplers[ch][i - 1].process(data, data, size);
+            size /= 2;
+        }
+        downsamplers[ch][0].process(data, output.getData(), size);
+    }
+};
+
+#endif
@@ -96,9 +96,9 @@ private:
     float fm_ratio;
     float fm_amount;
     VoltsPerOctave hz;
-    DelayLine<Point, 128> preview_buf;
-    DelayLine<Point, 128> lfo_preview_buf;
-    DelayLine<float, MAX_DELAY> delayBufferL, delayBufferR;
+    PowerOfTwoDelayLine<Point, 128> preview_buf;
+    PowerOfTwoDelayLine<Point, 128> lfo_preview_buf;
+    PowerOfTwoDelayLine<float, MAX_DELAY> delayBufferL, delayBufferR;
     StereoBiquadFilter* highpass;
     StereoBiquadFilter* lowpass;
     int delayL, delayR;    
@@ -154,11 +154,11 @@ public:
         registerParameter(PARAMETER_BC, "AttrX>");
         registerParameter(PARAMETER_BD, "AttrY>");
         preview = FloatArray::create(SCREEN_PREVIEW_BUF_SIZE);
-        preview_buf = DelayLine<Point, 128>::create();
-        lfo_preview_buf = DelayLine<Point, 128>::create();
+        preview_buf = PowerOfTwoDelayLine<Point, 128>::create();
+        lfo_preview_buf = PowerOfTwoDelayLine<Point, 128>::create();
         env_copy = FloatArray::create(getBlockSize());
-        delayBufferL = DelayLine<float, MAX_DELAY>::create();
-        delayBufferR = DelayLine<float, MAX_DELAY>::create();        
+        delayBufferL = PowerOfTwoDelayLine<float, MAX_DELAY>::create();
+        delayBufferR = PowerOfTwoDelayLine<float, MAX_DELAY>::create();        
 #ifdef OVERSAMPLE_FACTOR
         upsampler_pitch = UpSampler::create(1, OVERSAMPLE_FACTOR);
         upsampler_fm = UpSampler::create(1, OVERSAMPLE_FACTOR);
@@ -175,11 +175,11 @@ public:
 
     ~PolygonalMagusPatch() {
         FloatArray::destroy(preview);
-        DelayLine<Point, 128>::destroy(preview_buf);
-        DelayLine<Point, 128>::destroy(lfo_preview_buf);
+        PowerOfTwoDelayLine<Point, 128>::destroy(preview_buf);
+        PowerOfTwoDelayLine<Point, 128>::destroy(lfo_preview_buf);
         FloatArray::destroy(env_copy);
-        DelayLine<float, MAX_DELAY>::destroy(delayBufferL);
-        DelayLine<float, MAX_DELAY>::destroy(delayBufferR);
+        PowerOfTwoDelayLine<float, MAX_DELAY>::destroy(delayBufferL);
+        PowerOfTwoDelayLine<float, MAX_DELAY>::destroy(delayBufferR);
         StereoBiquadFilter::destroy(highpass);
         StereoBiquadFilter::destroy(lowpass);
 #ifdef OVERSAMPLE_FACTOR
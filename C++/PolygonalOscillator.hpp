@@ -9,6 +9,8 @@
 
 #include <cmath>
 #include "ComplexOscillator.h"
+#include "FastTrig.hpp"
+#include "LinearRamp.hpp"
 
 class PolygonalOscillator : public ComplexOscillator {
 public:
@@ -24,10 +26,9 @@ public:
     };
     PolygonalOscillator()
         : mul(0.0)
-        , nfreq(0.0)
         , phase(0)
-        , nPolyQuant(NONE)
-        , feedback() {
+        , nPolyQuant(NONE) {
+        setParams(NONE, 0, 0);
     }
     void setSampleRate(float sr) override {
         mul = M_PI * 2 / sr;
@@ -37,10 +38,16 @@ public:
     }
 
     void setFrequency(float freq) override {
-        nfreq = mul * freq;
+        nfreq.set(mul * freq);
+    }
+    /**
+     * Ramp frequency over next rendered block
+     */
+    void rampFrequency(float freq) {
+        nfreq.ramp(mul * freq);
     }
     float getFrequency() override {
-        return nfreq / mul;
+        return nfreq.getEnd() / mul;
     }
     void setPhase(float phase) override {
         this->phase = phase / (M_PI * 2.0);
@@ -49,10 +56,90 @@ public:
         return phase * 2.0 * M_PI;
     }
     void setFeedback(float angle, float magnitude) {
-        feedback.setPolar(magnitude, angle);
+        feedback_re.set(magnitude * cosf(angle));
+        feedback_im.set(magnitude * sinf(angle));
+    }
+    /**
+     * Ramp feedback over next rendered block
+     */
+    void rampFeedback(float angle, float magnitude) {
+        feedback_re.ramp(magnitude * cosf(angle));
+        feedback_im.ramp(magnitude * sinf(angle));
     }
     void setParams(NPolyQuant quant, float nPoly, float teeth) {
         nPolyQuant = quant;
+        shape.set(getShape(quant, nPoly, teeth));
+    }
+    /**
+     * Ramp polygon shape over next rendered block. Shape constants are
+     * interpolated linearly, so only the ends of the ramp are exact.
+     */
+    void rampParams(NPolyQuant quant, float nPoly, float teeth) {
+        nPolyQuant = quant;
+        shape.ramp(getShape(quant, nPoly, teeth));
+    }
+    ComplexFloat generate() {
+        ComplexFloat sample;
+        render<false>(1, nullptr, &sample);
+        return sample;
+    }
+    ComplexFloat generate(float fm) {
+        ComplexFloat sample;
+        render<true>(1, &fm, &sample);
+        return sample;
+    }
+    void generate(ComplexFloatArray output) {
+        render<false>(output.getSize(), nullptr, output.getData());
+    }
+    void generate(ComplexFloatArray output, FloatArray fm) override {
+        render<true>(output.getSize(), fm.getData(), output.getData());
+    }
+    // using ComplexOscillator::generate;
+
+    static PolygonalOscillator* create(float sr) {
+        auto osc = new PolygonalOscillator();
+        osc->setSampleRate(sr);
+        return osc;
+    }
+
+    static void destroy(PolygonalOscillator* poly) {
+        delete poly;
+    }
+
+protected:
+    /**
+     * Polygon constants that depend only on nPoly and teeth
+     */
+    struct Shape {
+        float n_poly, teeth, gain;
+        float cos_angle, half_turn, teeth_turn;
+        float blep_gain, blam_gain;
+
+        Shape operator-(const Shape& other) const {
+            return { n_poly - other.n_poly, teeth - other.teeth,
+                gain - other.gain, cos_angle - other.cos_angle,
+                half_turn - other.half_turn, teeth_turn - other.teeth_turn,
+                blep_gain - other.blep_gain, blam_gain - other.blam_gain };
+        }
+        Shape operator*(float scale) const {
+            return { n_poly * scale, teeth * scale, gain * scale,
+                cos_angle * scale, half_turn * scale, teeth_turn * scale,
+                blep_gain * scale, blam_gain * scale };
+        }
+        Shape& operator+=(const Shape& other) {
+            n_poly += other.n_poly;
+            teeth += other.teeth;
+            gain += other.gain;
+            cos_angle += other.cos_angle;
+            half_turn += other.half_turn;
+            teeth_turn += other.teeth_turn;
+            blep_gain += other.blep_gain;
+            blam_gain += other.blam_gain;
+            return *this;
+        }
+    };
+
+    static Shape getShape(NPolyQuant quant, float nPoly, float teeth) {
         nPoly *= 20.0;
         switch (quant) {
         case NONE:
@@ -77,7 +164,8 @@ public:
         default:
             break;
         }
-        this->nPoly = nPoly;
+        Shape shape;
+        shape.n_poly = nPoly;
 
         // Adapt the teeth value to nPoly
         if (nPoly < 5.f) {
@@ -86,103 +174,78 @@ public:
         else {
             teeth = teeth * (-0.0019f * nPoly * nPoly + 0.07f * nPoly + 0.2875f);
         }
-        this->teeth = teeth;
-        gain = 0.5f - 0.25f * teeth;
-    }
-    ComplexFloat generate() {
-        ComplexFloat sample;
-        render<false>(1, nullptr, &sample);
-        return sample;
-    }
-    ComplexFloat generate(float fm) {
-        ComplexFloat sample;
-        render<true>(1, &fm, &sample);
-        return sample;
-    }
-    void generate(ComplexFloatArray output) {
-        render<false>(output.getSize(), nullptr, output.getData());
-    }
-    void generate(ComplexFloatArray output, FloatArray fm) override {
-        render<true>(output.getSize(), fm.getData(), output.getData());
-    }
-    // using ComplexOscillator::generate;
+        shape.teeth = teeth;
+        shape.gain = 0.5f - 0.25f * teeth;
 
-    static PolygonalOscillator* create(float sr) {
-        auto osc = new PolygonalOscillator();
-        osc->setSampleRate(sr);
-        return osc;
+        // Polygon constants, everything that doesn't change per sample
+        float angle = M_PI / nPoly;
+        shape.cos_angle = cosf(angle);
+        shape.half_turn = 0.5f / nPoly;
+        shape.teeth_turn = teeth / (2 * M_PI);
+        float cos_lo = cosf(teeth - angle);
+        float cos_hi = cosf(teeth + angle);
+        shape.blep_gain = shape.cos_angle * (1.f / cos_lo - 1.f / cos_hi);
+        shape.blam_gain = shape.cos_angle * 2 * M_PI *
+            (tanf(teeth - angle) / cos_lo - tanf(teeth + angle) / cos_hi);
+        return shape;
     }
 
-    static void destroy(PolygonalOscillator* poly) {
-        delete poly;
-    }
-
-protected:
     template <bool with_fm>
     void render(size_t size, float* fm, ComplexFloat* out) {
         float _last_p = lastP;
         float _last_x = lastX;
         float _last_y = lastY;
+        // Parameters are ramped, step is 0 when they were set directly
+        float freq = nfreq.getStart();
+        const float freq_step = nfreq.getStep(size);
+        float fb_re = feedback_re.getStart();
+        const float fb_re_step = feedback_re.getStep(size);
+        float fb_im = feedback_im.getStart();
+        const float fb_im_step = feedback_im.getStep(size);
+        Shape s = shape.getStart();
+        const Shape s_step = shape.getStep(size);
         while (size--) {
-            phase += nfreq;
+            freq += freq_step;
+            fb_re += fb_re_step;
+            fb_im += fb_im_step;
+            s += s_step;
+
+            phase += freq;
             if (phase >= 1.0f)
                 phase -= 1.f;
             else if (phase < 0.0f)
                 phase += 1.f;
 
             if constexpr (with_fm) // Actually PM
-                phase += nfreq * *fm++;
+                phase += freq * *fm++;
 
-            modPhase += nfreq * nPoly;
+            modPhase += freq * s.n_poly;
             // Increment phase and check if there is a discontinuity, if
             // necessary compute data for PolyBlep and PolyBlam
             correction = 0.f;
-            float phi = phase * 2.f * M_PI;
-            if (modPhase >= 1.0f) {
-                fracDelay = (modPhase - 1.f) / (modPhase - modPhasePrev);
-                tmp1 = 2.f * M_PI * nfreq;
-                PhiTr = phi - fracDelay * tmp1;
-                if (teeth > 0.f) {
-                    tmp2 = cos(M_PI / nPoly) *
-                        (1.f / cos(-1.f * M_PI / nPoly + teeth) -
-                            1.f / cos(M_PI / nPoly + teeth));
-                    fx = cos(phi) * tmp2;
-                    fy = sin(phi) * tmp2;
-                }
-                tmp2 = cos(M_PI / nPoly) *
-                    (tan(teeth - (M_PI / nPoly)) / cos(teeth - (M_PI / nPoly)) -
-                        tan(teeth + (M_PI / nPoly)) / cos(teeth + (M_PI / nPoly)));
-                // tmp2 = -2.f * std::tan(M_PI/NPoly);
-                fxprime = tmp2 * cos(PhiTr) * tmp1;
-                fyprime = tmp2 * sin(PhiTr) * tmp1;
-                correction = 1.0;
-                modPhase -= floor(modPhase);
-            }
-            else if (modPhase < 0.0f) {
-                fracDelay = modPhase / (modPhase - modPhasePrev);
-                tmp1 = 2.f * M_PI * nfreq;
-                PhiTr = phi - fracDelay * tmp1;
-                if (teeth > 0.f) {
-                    tmp2 = cos(M_PI / nPoly) *
-                        (1.f / cos(-M_PI / nPoly + teeth) -
-                            1.f / cos(M_PI / nPoly + teeth));
-                    fx = -cos(phi) * tmp2;
-                    fy = -sin(phi) * tmp2;
+            if (modPhase >= 1.0f || modPhase < 0.0f) {
+                // Corners are crossed in opposite direction for negative frequency
+                float direction = modPhase >= 1.0f ? 1.f : -1.f;
+                float edge = modPhase >= 1.0f ? modPhase - 1.f : modPhase;
+                fracDelay = edge / (modPhase - modPhasePrev);
+                if (s.teeth > 0.f) {
+                    tmp2 = direction * s.blep_gain;
+                    fx = FastTrig::cos(phase) * tmp2;
+                    fy = FastTrig::sin(phase) * tmp2;
                 }
-                tmp2 = -1.f * cos(M_PI / nPoly) *
-                    (tan(teeth - (M_PI / nPoly)) / cos(teeth - (M_PI / nPoly)) -
-                        tan(teeth + (M_PI / nPoly)) / cos(teeth + (M_PI / nPoly)));
-                // tmp2 = 2.f * std::tan(M_PI/NPoly);
-                fxprime = tmp2 * cos(PhiTr) * tmp1;
-                fyprime = tmp2 * sin(PhiTr) * tmp1;
+                float phase_tr = phase - fracDelay * freq;
+                tmp2 = direction * s.blam_gain * freq;
+                fxprime = tmp2 * FastTrig::cos(phase_tr);
+                fyprime = tmp2 * FastTrig::sin(phase_tr);
                 correction = 1.0;
-                modPhase -= floor(modPhase);
+                modPhase -= floorf(modPhase);
             }
 
             // Create Polygon
-            P = cos(M_PI / nPoly) / cos((2 * modPhase - 1) * M_PI / nPoly + teeth);
-            x = cos(phi + _last_x * feedback.re) * P;
-            y = sin(phi + _last_y * feedback.im) * P;
+            P = s.cos_angle /
+                FastTrig::cos((2 * modPhase - 1) * s.half_turn + s.teeth_turn);
+            x = FastTrig::cos(phase + _last_x * fb_re * inv_turn) * P;
+            y = FastTrig::sin(phase + _last_y * fb_im * inv_turn) * P;
             _last_p = P;
             _last_x = x;
             _last_y = y;
@@ -199,7 +262,7 @@ protected:
                 d5 = d4 * d1;
 
                 // PolyBlep correction (if teeth is not zero)
-                if (teeth > 0.f) {
+                if (s.teeth > 0.f) {
                     h3 = 0.03871f * d4 + 0.00617f * d3 + 0.00737f * d2 + 0.00029f * d1;
                     h2 = -0.11656f * d4 + 0.14955f * d3 + 0.22663f * d2 +
                         0.18783f * d1 + 0.05254f;
@@ -220,12 +283,12 @@ protected:
                 }
 
                 // PolyBlam Correction
-                h0 = -0.008333 * d5 + 0.041667 * d4 - 0.083333 * d3 +
-                    0.083333 * d2 - 0.041667 * d1 + 0.008333;
-                h1 = 0.025 * d5 - 0.083333 * d4 + 0.333333 * d2 - 0.5 * d1 + 0.233333;
-                h2 = -0.025 * d5 + 0.041667 * d4 + 0.083333 * d3 +
-                    0.083333 * d2 + 0.041667 * d1 + 0.008333;
-                h3 = 0.008333 * d5;
+                h0 = -0.008333f * d5 + 0.041667f * d4 - 0.083333f * d3 +
+                    0.083333f * d2 - 0.041667f * d1 + 0.008333f;
+                h1 = 0.025f * d5 - 0.083333f * d4 + 0.333333f * d2 - 0.5f * d1 + 0.233333f;
+                h2 = -0.025f * d5 + 0.041667f * d4 + 0.083333f * d3 +
+                    0.083333f * d2 + 0.041667f * d1 + 0.008333f;
+                h3 = 0.008333f * d5;
 
                 xout0 = xout0 + fxprime * h0;
                 xout1 = xout1 + fxprime * h1;
@@ -238,8 +301,8 @@ protected:
                 yout3 = yout3 + fyprime * h3;
             }
             // Output
-            xout = gain * xout3;
-            yout = clamp(gain * yout3, -1.f, 1.f);
+            xout = s.gain * xout3;
+            yout = clamp(s.gain * yout3, -1.f, 1.f);
 
             // Keep values for the next iteration
             modPhasePrev = modPhase;
@@ -258,22 +321,28 @@ protected:
         lastP = _last_p;
         lastX = _last_x;
         lastY = _last_y;
+        nfreq.finish();
+        feedback_re.finish();
+        feedback_im.finish();
+        shape.finish();
     }
 
-    float nPoly = 0.f, P = 0.f;
-    float phase = 0.f, nfreq = 0.f, mul = 0.f;
+    float P = 0.f;
+    float phase = 0.f, mul = 0.f;
+    LinearRamp<float> nfreq;
     float modPhase = 0.f, modPhasePrev = 0.f;
     NPolyQuant nPolyQuant = NONE;
 
-    float x, y, tmp1, tmp2;
-    float teeth = 0.f, fracDelay, PhiTr, fxprime, fyprime, fx, fy,
-          correction = 0.f, gain = 1.f;
-    float xout0, xout1, xout2, xout3, xout;
-    float yout0, yout1, yout2, yout3, yout;
+    float x, y, tmp2;
+    float fracDelay, fxprime, fyprime, fx, fy, correction = 0.f;
+    float xout0 = 0.f, xout1 = 0.f, xout2 = 0.f, xout3 = 0.f, xout;
+    float yout0 = 0.f, yout1 = 0.f, yout2 = 0.f, yout3 = 0.f, yout;
 
     float h0, h1, h2, h3, d1, d2, d3, d4, d5;
     float lastP = 0.f, lastX = 0.f, lastY = 0.f;
-    ComplexFloat feedback {};
+    LinearRamp<Shape> shape;
+    LinearRamp<float> feedback_re, feedback_im;
+    static constexpr float inv_turn = 1 / (2 * M_PI);
 };
 
 #endif
@@ -0,0 +1,80 @@
+#ifndef __REVERB_DELAYS_HPP__
+#define __REVERB_DELAYS_HPP__
+
+#include <stddef.h>
+#include <math.h>
+
+/**
+ * Delay line lengths in samples, tuned for given sample rate.
+ *
+ * Reverbs convert lengths and modulation to their actual sample rate in
+ * create(), so that a table sounds the same at any sample rate.
+ */
+template <size_t num_delays>
+struct ReverbDelays {
+    float sample_rate;
+    size_t lengths[num_delays];
+
+    float getScale(float sr) const {
+        return sr / sample_rate;
+    }
+
+    /**
+     * Convert lengths to sample rate sr. Every scaled length is rounded to
+     * the closest value that is coprime with all lengths before it, so that
+     * resonances of different lines don't line up.
+     */
+    void scale(float sr, size_t* output) const {
+        float ratio = getScale(sr);
+        for (size_t i = 0; i < num_delays; i++) {
+            size_t length = scale(lengths[i], ratio);
+            size_t candidate = length;
+            for (size_t step = 1; !isCoprime(candidate, output, i); step++) {
+                // Try length + 1, length - 1, length + 2, length - 2...
+                size_t offset = (step + 1) / 2;
+                if (step & 1)
+                    candidate = length + offset;
+                else
+                    candidate = offset < length ? length - offset : 0;
+            }
+            output[i] = candidate;
+        }
+    }
+
+    static size_t scale(size_t length, float ratio) {
+        size_t scaled = (size_t)roundf(length * ratio);
+        return scaled > 1 ? scaled : 1;
+    }
+
+    /**
+     * Damping coefficient of a one pole lowpass that keeps the same cutoff
+     * frequency at sample rate scaled by ratio. Damping is clamped to [0, 1],
+     * as patches may overshoot it and powf() would return NaN.
+     */
+    static float scaleDamping(float damping, float ratio) {
+        damping = fminf(fmaxf(damping, 0.f), 1.f);
+        return 1 - powf(1 - damping, 1 / ratio);
+    }
+
+private:
+    static size_t gcd(size_t a, size_t b) {
+        while (b) {
+            size_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    static bool isCoprime(size_t length, const size_t* others, size_t count) {
+        if (length < 2)
+            return false;
+        for (size_t i = 0; i < count; i++) {
+            if (gcd(length, others[i]) != 1)
+                return false;
+        }
+        return true;
+    }
+};
+
+#endif
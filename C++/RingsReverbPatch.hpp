@@ -1,4 +1,4 @@
-#include "DattorroReverb.hpp"
+#include "DattorroBlockReverb.hpp"
 #include "Nonlinearity.hpp"
 #include "Patch.h"
 #include "SmoothValue.h"
@@ -13,7 +13,7 @@
 #define MAX_PRE_DELAY 120 // In ms
 
 using Saturator = AntialiasedThirdOrderPolynomial;
-using RingsReverb = DattorroReverb<false>;
+using RingsReverb = DattorroBlockReverb<false>;
 
 class RingsReverbPatch : public Patch {
 public:
@@ -2,6 +2,7 @@
 #define __ROSE_OSCILLATOR_HPP__
 
 #include "ComplexOscillator.h"
+#include "LinearRamp.hpp"
 
 /**
  * A complex (quadrature) oscillator based on Rose (rhodonea curve).
@@ -12,8 +13,6 @@ class RoseOscillator : public ComplexOscillator {
 public:
     RoseOscillator(float sr = 48000)
         : mul(2 * M_PI / sr) {
-        feedback2.re = 0.f;
-        feedback2.im = 0.f;
     }
     RoseOscillator(float freq, float sr)
         : RoseOscillator(sr) {
@@ -34,10 +33,16 @@ public:
         return (2 * M_PI) / mul;
     }
     void setFrequency(float freq) {
-        incr = freq * mul;
+        incr.set(freq * mul);
+    }
+    /**
+     * Ramp frequency over next rendered block
+     */
+    void rampFrequency(float freq) {
+        incr.ramp(freq * mul);
     }
     float getFrequency() {
-        return incr / mul;
+        return incr.getEnd() / mul;
     }
     void setPhase(float ph) {
         phase = ph;
@@ -46,13 +51,24 @@ public:
         return phase;
     }
     void setFeedback1(float feedback) {
-        feedback1 = feedback;
+        feedback1.set(feedback);
+    }
+    void rampFeedback1(float feedback) {
+        feedback1.ramp(feedback);
     }
     void setFeedback2(float magnitude, float phase) {
-        feedback2.setPolar(magnitude, phase);
+        feedback2_re.set(magnitude * cosf(phase));
+        feedback2_im.set(magnitude * sinf(phase));
+    }
+    void rampFeedback2(float magnitude, float phase) {
+        feedback2_re.ramp(magnitude * cosf(phase));
+        feedback2_im.ramp(magnitude * sinf(phase));
     }
     void setHarmonics(float harmonics) {
-        this->harmonics = harmonics;
+        this->harmonics.set(harmonics);
+    }
+    void rampHarmonics(float harmonics) {
+        this->harmonics.ramp(harmonics);
     }
     void generate(AudioBuffer& output) override {
         render<false>(output.getSize(), NULL, output.getSamples(0).getData(),
@@ -70,25 +86,41 @@ public:
 
 protected:
     float mul = 0.f;
-    float incr = 0.f;
+    LinearRamp<float> incr = 0.f;
     float phase = 0.f;
-    float harmonics = 1.f;
+    LinearRamp<float> harmonics = 1.f;
     float k = 1.f;
     float modPhase = 0.f;
-    float feedback1 = 0.f;
-    ComplexFloat feedback2;
+    LinearRamp<float> feedback1 = 0.f;
+    LinearRamp<float> feedback2_re = 0.f, feedback2_im = 0.f;
     float last_x = 0.f, last_y = 0.f, last_t = 0.f;
 
     template <bool with_fm>
     void render(size_t size, float* fm, float* out_x, float* out_y) {
+        // Parameters are ramped, step is 0 when they were set directly
+        float inc = incr.getStart();
+        const float inc_step = incr.getStep(size);
+        float h = harmonics.getStart();
+        const float h_step = harmonics.getStep(size);
+        float fb1 = feedback1.getStart();
+        const float fb1_step = feedback1.getStep(size);
+        float fb_re = feedback2_re.getStart();
+        const float fb_re_step = feedback2_re.getStep(size);
+        float fb_im = feedback2_im.getStart();
+        const float fb_im_step = feedback2_im.getStep(size);
         while (size--) {
-            float t = 1.f - harmonics + harmonics * cosf(modPhase + last_t * feedback1);
+            inc += inc_step;
+            h += h_step;
+            fb1 += fb1_step;
+            fb_re += fb_re_step;
+            fb_im += fb_im_step;
+            float t = 1.f - h + h * cosf(modPhase + last_t * fb1);
             last_t = t;
-            float x = cosf(phase + last_x * feedback2.re) * t;
-            float y = sinf(phase + last_y * feedback2.im) * t;
+            float x = cosf(phase + last_x * fb_re) * t;
+            float y = sinf(phase + last_y * fb_im) * t;
 
-            phase += incr;
-            modPhase += k * incr;
+            phase += inc;
+            modPhase += k * inc;
             if (with_fm) {
                 //                modPhase += *fm;
                 phase += *fm++;
@@ -106,6 +138,11 @@ protected:
             *out_y++ = y;
             last_y = y;
         }
+        incr.finish();
+        harmonics.finish();
+        feedback1.finish();
+        feedback2_re.finish();
+        feedback2_im.finish();
     }
 };
 
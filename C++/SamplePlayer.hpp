@@ -12,32 +12,30 @@ enum SamplePlayerState {
     SP_PLAY,
 };
 
+/**
+ * Buffer can be a FloatArray or any type that returns float samples by
+ * index, such as WavSampleView.
+ */
 template <InterpolationMethod im>
 struct SamplePlayerInterpolation {
-    static float interpolate(float index, FloatArray data);
+    template <typename Buffer>
+    static float interpolate(float index, const Buffer& data) {
+        size_t idx = (int)index;
+        if constexpr (im == COSINE_INTERPOLATION)
+            return Interpolator::cosine(data[idx], data[idx + 1], index - idx);
+        else
+            return Interpolator::linear(data[idx], data[idx + 1], index - idx);
+    }
 };
 
-template <>
-float SamplePlayerInterpolation<LINEAR_INTERPOLATION>::interpolate(
-    float index, FloatArray data) {
-    size_t idx = (int)index;
-    return Interpolator::linear(data[idx], data[idx + 1], index - idx);
-}
-
-template <>
-float SamplePlayerInterpolation<COSINE_INTERPOLATION>::interpolate(
-    float index, FloatArray data) {
-    size_t idx = (int)index;
-    return Interpolator::cosine(data[idx], data[idx + 1], index - idx);
-}
-
-template <InterpolationMethod im, CrossfadeShape cf, size_t fade_size, size_t grid_size = 1>
+template <InterpolationMethod im, CrossfadeShape cf, size_t fade_size, size_t grid_size = 1,
+    typename Buffer = FloatArray>
 class SamplePlayer : public SignalGenerator {
 public:
     using Crossfade = Crossfader<cf>;
 
     SamplePlayer() = default;
-    SamplePlayer(float sr, FloatArray buffer)
+    SamplePlayer(float sr, Buffer buffer)
         : sr(sr)
         , buffer(buffer)
         , rate(1.0)
@@ -141,7 +139,7 @@ public:
         }
         return sample;
     }
-    static SamplePlayer* create(float sr, FloatArray buf, float max_rate) {
+    static SamplePlayer* create(float sr, Buffer buf, float max_rate) {
         auto sampler = new SamplePlayer(sr, buf);
         sampler->start = sampler->findZeroCrossing(0, true);
         sampler->end = sampler->findZeroCrossing(buf.getSize() - fade_size * max_rate, false);
@@ -159,7 +157,7 @@ protected:
     SamplePlayerState state;
     size_t start, end, length;
     float sr, rate, pos, transition, transition_step;
-    FloatArray buffer;
+    Buffer buffer;
     bool is_looping;
     size_t fade_start, output_length;
     size_t loop_points[grid_size];
@@ -8,8 +8,11 @@
 #define P_TEMPO PARAMETER_B
 
 
-using Player = SamplePlayer<COSINE_INTERPOLATION, CROSSFADE_PARABOLIC, 64, GRID_SIZE>;
-//using Player = SamplePlayer<LINEAR_INTERPOLATION, CROSSFADE_LINEAR, 64>;
+// Samples are played directly from resource data, type must match WAV format.
+// Patch stays silent if resource is missing or has another format.
+using SampleView = WavSampleView<int16_t>;
+using Player = SamplePlayer<COSINE_INTERPOLATION, CROSSFADE_PARABOLIC, 64, GRID_SIZE, SampleView>;
+//using Player = SamplePlayer<LINEAR_INTERPOLATION, CROSSFADE_LINEAR, 64, 1, SampleView>;
 
 const char* player_states[] = {
     "None",
@@ -22,20 +25,24 @@ const char* player_states[] = {
 class SamplePlayerPatch : public MonochromeScreenPatch {
 public:
     Player* player;
-    FloatArray sample_buf;
+    SampleView sample_buf;
     AdjustableTapTempo* tempo;
     SamplePlayerPatch() {
         registerParameter(P_INDEX, "Loop point");
         registerParameter(P_TEMPO, "Tempo");
-        sample_buf = WavLoader::load("breaks/jungle2.wav");
-        player = Player::create(getSampleRate(), sample_buf, 4.0);
+        sample_buf = WavLoader::view<int16_t>("breaks/jungle2.wav");
+        player = NULL;
+        if (!sample_buf.isEmpty()) {
+            player = Player::create(getSampleRate(), sample_buf, 4.0);
+            player->setLooping(true);
+            // player->trigger();
+        }
         tempo = AdjustableTapTempo::create(getSampleRate(), 1 << 22);
-        player->setLooping(true);
-        // player->trigger();
     }
     ~SamplePlayerPatch() {
-        Player::destroy(player);
-        FloatArray::destroy(sample_buf);
+        if (player != NULL)
+            Player::destroy(player);
+        SampleView::destroy(sample_buf);
         AdjustableTapTempo::destroy(tempo);
     }
     void buttonChanged(PatchButtonId bid, uint16_t value, uint16_t samples) override {
@@ -45,12 +52,16 @@ public:
             tempo->trigger(set, samples);
             break;
         case BUTTON_B:
-            if (value)
+            if (value && player != NULL)
                 player->trigger();
             break;
         }
     }
     void processScreen(MonochromeScreenBuffer& screen) override {
+        if (player == NULL) {
+            screen.print(1, 10, "No int16 sample");
+            return;
+        }
         screen.print(1, 10, "State=");
         screen.print(player_states[(int)player->getState()]);
         screen.print(1, 20, "Pos=");
@@ -61,6 +72,10 @@ public:
     void processAudio(AudioBuffer& buffer) {
         tempo->clock(buffer.getSize());
         tempo->adjust(getParameterValue(P_TEMPO) * 4096);
+        if (player == NULL) {
+            buffer.clear();
+            return;
+        }
         player->setDuration(tempo->getPeriodInSamples());
         player->setLoopPoint(getParameterValue(P_INDEX) * GRID_SIZE);
         //player->setBPM(tempo->getBeatsPerMinute());
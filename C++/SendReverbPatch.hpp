@@ -1,4 +1,4 @@
-#include "DattorroReverb.hpp"
+#include "DattorroBlockReverb.hpp"
 #include "Nonlinearity.hpp"
 #include "Patch.h"
 #include "SmoothValue.h"
@@ -22,7 +22,7 @@ using Saturator = AntialiasedReciprocalSaturator;
 //using Saturator = AliasingTanhSaturator;
 //using Saturator = AntialiasedThirdOrderPolynomial;
 //using Saturator = AntialiasedCubicSaturator;
-using RingsReverb = DattorroReverb<false>;
+using RingsReverb = DattorroBlockReverb<false>;
 
 class SendReverbPatch : public Patch {
 public:
@@ -0,0 +1,110 @@
+#ifndef __TABULATED_NONLINEARITY_HPP__
+#define __TABULATED_NONLINEARITY_HPP__
+
+#include "Nonlinearity.hpp"
+
+/**
+ * Nonlinearity that replaces Function and its antiderivatives with lookup
+ * tables over [-range..range], so that any shaper costs a few multiply-adds
+ * per sample regardless of how expensive its math is.
+ *
+ * Tables are generated once at startup. Antiderivatives are interpolated as
+ * cubic Hermite splines, using the table of their derivative for slopes,
+ * while the function itself is interpolated linearly. Outside of the range
+ * the function is held at its edge value and antiderivatives are continued
+ * accordingly, so range should cover the part where Function is not yet
+ * saturated.
+ *
+ * Second antiderivative is only tabulated with second_order set, as not
+ * every nonlinearity implements it.
+ */
+template <typename Function, size_t table_size = 1024, int range = 4,
+    bool second_order = false>
+class TabulatedNonlinearity : public Nonlinearity {
+public:
+    static float getSample(float x) {
+        float c = clamp(x);
+        size_t i;
+        float t = getPosition(c, i);
+        const float* f0 = tables.f0;
+        return f0[i] + (f0[i + 1] - f0[i]) * t;
+    }
+    static float getAntiderivative1(float x) {
+        float c = clamp(x);
+        size_t i;
+        float t = getPosition(c, i);
+        float f0 = tables.f0[i] + (tables.f0[i + 1] - tables.f0[i]) * t;
+        return hermite(tables.f1, tables.f0, i, t) + f0 * (x - c);
+    }
+    static float getAntiderivative2(float x) {
+        static_assert(second_order, "Second antiderivative is not tabulated");
+        float c = clamp(x);
+        float d = x - c;
+        size_t i;
+        float t = getPosition(c, i);
+        float f0 = tables.f0[i] + (tables.f0[i + 1] - tables.f0[i]) * t;
+        float f1 = hermite(tables.f1, tables.f0, i, t);
+        return hermite(tables.f2, tables.f1, i, t) + (f1 + f0 * d * 0.5f) * d;
+    }
+
+protected:
+    static constexpr float step = 2.0f * range / table_size;
+
+    struct Tables {
+        float f0[table_size + 1];
+        float f1[table_size + 1];
+        float f2[second_order ? table_size + 1 : 1];
+
+        Tables() {
+            for (size_t i = 0; i <= table_size; i++) {
+                float x = i * step - range;
+                f0[i] = Function::getSample(x);
+                f1[i] = Function::getAntiderivative1(x);
+                if constexpr (second_order)
+                    f2[i] = Function::getAntiderivative2(x);
+            }
+        }
+    };
+    static inline const Tables tables;
+
+    static float clamp(float x) {
+        return x < -range ? -range : (x > range ? range : x);
+    }
+
+    /**
+     * Table index and fractional part for x within range
+     */
+    static float getPosition(float x, size_t& index) {
+        float pos = (x + range) * (1.0f / step);
+        index = (size_t)pos;
+        index = index < table_size ? index : table_size - 1;
+        return pos - index;
+    }
+
+    /**
+     * Cubic Hermite interpolation of values with slopes taken from their
+     * derivative table
+     */
+    static float hermite(const float* values, const float* slopes, size_t i, float t) {
+        float p0 = values[i];
+        float p1 = values[i + 1];
+        float m0 = slopes[i] * step;
+        float m1 = slopes[i + 1] * step;
+        float a = 3 * (p1 - p0) - 2 * m0 - m1;
+        float b = 2 * (p0 - p1) + m0 + m1;
+        return p0 + t * (m0 + t * (a + t * b));
+    }
+};
+
+using AntialiasedTabulatedTanhSaturator =
+    AntialiasedWaveshaperTemplate<TabulatedNonlinearity<TanhSaturator, 1024, 8>>;
+using AntialiasedTabulatedArctanSaturator =
+    AntialiasedWaveshaperTemplate<TabulatedNonlinearity<ArctanSaturator, 1024, 16>>;
+using AntialiasedTabulatedSineSaturator =
+    AntialiasedWaveshaperTemplate<TabulatedNonlinearity<SineSaturator, 512, 1>>;
+using AntialiasedTabulatedQuadraticSineSaturator =
+    AntialiasedWaveshaperTemplate<TabulatedNonlinearity<QuadraticSineSaturator, 512, 1>>;
+using AntialiasedTabulatedCubicSineSaturator =
+    AntialiasedWaveshaperTemplate<TabulatedNonlinearity<CubicSineSaturator, 512, 1>>;
+
+#endif
@@ -1,9 +1,91 @@
-#ifndef __WAVE_LOADER_HPP__
+#ifndef __WAV_LOADER_HPP__
 #define __WAV_LOADER_HPP__
 
 #include "WavFile.h"
 #include "OpenWareLibrary.h"
 
+/**
+ * 24 bit sample type for WavSampleView
+ */
+struct WavInt24 {
+    uint8_t bytes[3];
+};
+
+/**
+ * Conversion of WAV sample formats to float. Samples are read with memcpy,
+ * because data chunk is not guaranteed to be aligned.
+ */
+template <typename T>
+struct WavSample;
+
+template <>
+struct WavSample<int16_t> {
+    static constexpr uint16_t format = 1; // PCM
+    static constexpr uint16_t bits = 16;
+    static float read(const uint8_t* ptr) {
+        int16_t value;
+        memcpy(&value, ptr, sizeof(value));
+        return value * (1.f / 32768);
+    }
+};
+
+template <>
+struct WavSample<WavInt24> {
+    static constexpr uint16_t format = 1; // PCM
+    static constexpr uint16_t bits = 24;
+    static float read(const uint8_t* ptr) {
+        int32_t value = (ptr[0] << 8) | (ptr[1] << 16) | (ptr[2] << 24);
+        return value * (1.f / 2147483648.f);
+    }
+};
+
+template <>
+struct WavSample<float> {
+    static constexpr uint16_t format = 3; // IEEE float
+    static constexpr uint16_t bits = 32;
+    static float read(const uint8_t* ptr) {
+        float value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+};
+
+/**
+ * Read only view of one channel in WAV resource data. Samples are converted
+ * to float when they are indexed, so the view can replace a FloatArray in
+ * code that reads samples, without making a float copy of the file.
+ *
+ * View keeps its resource open until destroy() is called.
+ */
+template <typename T>
+class WavSampleView {
+public:
+    WavSampleView() = default;
+    WavSampleView(Resource* resource, const uint8_t* data, size_t size, size_t stride)
+        : resource(resource)
+        , data(data)
+        , size(size)
+        , stride(stride) {
+    }
+    float operator[](size_t index) const {
+        return WavSample<T>::read(data + index * stride);
+    }
+    size_t getSize() const {
+        return size;
+    }
+    bool isEmpty() const {
+        return size == 0;
+    }
+    static void destroy(WavSampleView view) {
+        Resource::destroy(view.resource);
+    }
+
+private:
+    Resource* resource = NULL;
+    const uint8_t* data = NULL;
+    size_t size = 0;
+    size_t stride = 0;
+};
 
 class WavLoader {
 public:
@@ -16,6 +98,7 @@ public:
 
         WavFile wav(resource->getData(), resource->getSize());
         if (!wav.isValid()) {
+            Resource::destroy(resource);
             error(CONFIGURATION_ERROR_STATUS, "Invalid wav");
             return FloatArray();
         }
@@ -24,6 +107,89 @@ public:
         Resource::destroy(resource);
         return array;
     }
+
+    /**
+     * Open WAV resource as a view of samples in channel. Memory mapped
+     * resources are used in place, others are loaded to RAM without
+     * conversion.
+     * @return empty view if resource is missing or its sample format is not T
+     */
+    template <typename T>
+    static WavSampleView<T> view(const char* name, size_t channel = 0) {
+        Resource* resource = Resource::open(name);
+        if (resource != NULL && !resource->isMemoryMapped()) {
+            Resource::destroy(resource);
+            resource = Resource::load(name);
+        }
+        if (resource == NULL) {
+            error(CONFIGURATION_ERROR_STATUS, "Missing Resource");
+            return WavSampleView<T>();
+        }
+        const uint8_t* data = resource->getData();
+        size_t size = resource->getSize();
+        size_t fmt_size = 0;
+        const uint8_t* fmt = findChunk(data, size, "fmt ", 16, &fmt_size);
+        size_t data_size = 0;
+        const uint8_t* samples = findChunk(data, size, "data", 0, &data_size);
+        if (fmt == NULL || samples == NULL) {
+            Resource::destroy(resource);
+            error(CONFIGURATION_ERROR_STATUS, "Invalid wav");
+            return WavSampleView<T>();
+        }
+        uint16_t format = read16(fmt);
+        if (format == 0xfffe) {
+            // WAVE_FORMAT_EXTENSIBLE, format code starts subformat GUID
+            format = fmt_size >= 40 ? read16(fmt + 24) : 0;
+        }
+        uint16_t channels = read16(fmt + 2);
+        uint16_t block_align = read16(fmt + 12);
+        uint16_t bits = read16(fmt + 14);
+        if (format != WavSample<T>::format || bits != WavSample<T>::bits ||
+            channel >= channels || block_align < channels * bits / 8) {
+            Resource::destroy(resource);
+            error(CONFIGURATION_ERROR_STATUS, "Unsupported wav format");
+            return WavSampleView<T>();
+        }
+        return WavSampleView<T>(resource, samples + channel * bits / 8,
+            data_size / block_align, block_align);
+    }
+
+private:
+    static uint16_t read16(const uint8_t* ptr) {
+        return ptr[0] | (ptr[1] << 8);
+    }
+
+    static uint32_t read32(const uint8_t* ptr) {
+        return read16(ptr) | (read16(ptr + 2) << 16);
+    }
+
+    /**
+     * Find body of a RIFF chunk that is at least min_size bytes long
+     */
+    static const uint8_t* findChunk(const uint8_t* data, size_t size, const char* id,
+        size_t min_size, size_t* chunk_size = NULL) {
+        if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+            return NULL;
+        size_t pos = 12;
+        while (pos + 8 <= size) {
+            size_t len = read32(data + pos + 4);
+            size_t available = size - pos - 8;
+            if (memcmp(data + pos, id, 4) == 0) {
+                // Truncated data chunk is used up to the end of resource
+                len = min(len, available);
+                if (len < min_size)
+                    return NULL;
+                if (chunk_size != NULL)
+                    *chunk_size = len;
+                return data + pos + 8;
+            }
+            // Corrupt size would wrap position around on 32 bit targets
+            if (len > available)
+                return NULL;
+            pos += 8 + len + (len & 1);
+        }
+        return NULL;
+    }
 };
 
 #endif
@@ -2,138 +2,213 @@
 #define __WAVE_TABLE_OSCILLATOR_HPP__
 
 #include "Oscillator.h"
-#include "InterpolatingCircularBuffer.h"
+#include "Interpolator.h"
 #include "WavLoader.hpp"
 
-template <InterpolationMethod im = LINEAR_INTERPOLATION>
-class WaveTableBuffer : public InterpolatingCircularFloatBuffer<im> {
-public:
-    void setData(float* data) {
-        this->data = data;
-    }
-    void setSize(size_t size) {
-        this->size = size;
-    }
-};
-
-class Integrator : public SignalProcessor {
+/**
+ * Single cycle wavetable oscillator with bandlimited mip levels.
+ *
+ * Every table is stored as num_mips levels of size samples, level m keeps
+ * harmonics up to size / 2^(m + 1). Levels are built from full bandwidth
+ * tables with generateMips(). Oscillator picks the brightest level that has
+ * no harmonics above Nyquist and crossfades with the next one by frequency,
+ * so output is alias free at any pitch.
+ *
+ * Block generate() renders without virtual calls per sample, FM input is
+ * applied as relative change of frequency. Size must be a power of 2.
+ */
+template <size_t size, size_t dims, InterpolationMethod im = LINEAR_INTERPOLATION>
+class WaveTableOscillator
+    : public OscillatorTemplate<WaveTableOscillator<size, dims, im>> {
 private:
-    float lambda;
-    float y;
+    using Base = OscillatorTemplate<WaveTableOscillator<size, dims, im>>;
+    static_assert((size & (size - 1)) == 0, "Table size must be a power of 2");
+    static_assert(im == NO_INTERPOLATION || im == LINEAR_INTERPOLATION ||
+            im == HERMITE_INTERPOLATION,
+        "Unsupported interpolation method");
+    static constexpr size_t mask = size - 1;
 
 public:
-    Integrator(float lambda = 0.995)
-        : lambda(lambda)
-        , y(0) {
-    }
-    void setSampleRate(float sr) {
-        mul = 1.f / sr;
-    }
-    void setCutoff(float fc) {
-        lambda = fc * mul;
-        if (lambda > 1.f)
-            lambda = 1.f;
-    }
-    /* process a single sample and return the result */
-    float process(float x) {
-        y = y * lambda + x * (1.0f - lambda);
-        return y;
-    }
-
-    void process(float* input, float* output, size_t size) {
-        float x;
-        while (size--) {
-            x = *input++;
-            y = y * lambda + x * (1.0f - lambda);
-            *output++ = y;
-        }
-    }
+    static constexpr size_t num_mips = __builtin_ctz(size);
+    static constexpr float begin_phase = 0.f;
+    static constexpr float end_phase = 1.f;
 
-    /* perform in-place processing */
-    void process(float* buf, int size) {
-        process(buf, buf, size);
-    }
+    size_t dimensions[dims];
 
-    void process(FloatArray in) {
-        process(in, in, in.getSize());
+    /**
+     * Data must contain num_mips levels for every table
+     */
+    WaveTableOscillator(float* data)
+        : Base()
+        , table_start(data)
+        , table(data) {
     }
 
-    void process(FloatArray in, FloatArray out) {
-        ASSERT(out.getSize() >= in.getSize(),
-            "output array must be at least as long as input");
-        process(in, out, in.getSize());
+    float getSample() {
+        float pos = this->phase * size;
+        size_t index = pos;
+        float frac = pos - index;
+        float sample = read(table + mip * size, index, frac);
+        if (mip_frac > 0.f) {
+            float next = read(table + (mip + 1) * size, index, frac);
+            sample += (next - sample) * mip_frac;
+        }
+        return sample;
     }
 
-    static SmoothingFilter* create(float lambda) {
-        return new SmoothingFilter(lambda);
+    using Base::generate;
+    void generate(FloatArray output) override {
+        if (mip_frac > 0.f)
+            render<true, false>(output.getData(), nullptr, output.getSize());
+        else
+            render<false, false>(output.getData(), nullptr, output.getSize());
     }
 
-    static void destroy(SmoothingFilter* obj) {
-        delete obj;
+    void generate(FloatArray output, FloatArray fm) override {
+        if (mip_frac > 0.f)
+            render<true, true>(output.getData(), fm.getData(), output.getSize());
+        else
+            render<false, true>(output.getData(), fm.getData(), output.getSize());
     }
 
-protected:
-    float mul = 1.f / 48000;
-};
-
-template <size_t size, size_t dims, InterpolationMethod im = LINEAR_INTERPOLATION>
-class WaveTableOscillator
-    : public OscillatorTemplate<WaveTableOscillator<size, dims, im>> {
-public:
-    size_t dimensions[dims];
-    WaveTableBuffer<im> samples;
-
-    WaveTableOscillator(float* data)
-        : OscillatorTemplate<WaveTableOscillator<size, dims, im>>() {
-        table_start = data;
-        samples.setData(table_start);
-        samples.setSize(size);
+    void setFrequency(float freq) override {
+        Base::setFrequency(freq);
+        // Level 0 reaches Nyquist when increment is 1 / (2 * size)
+        float level = log2f(std::abs(this->incr) * size) + 1;
+        if (level <= 0.f) {
+            mip = 0;
+            mip_frac = 0.f;
+        }
+        else if (level >= num_mips - 1) {
+            mip = num_mips - 1;
+            mip_frac = 0.f;
+        }
+        else {
+            mip = level;
+            mip_frac = level - mip;
+        }
     }
 
-    static constexpr float begin_phase = 0.f;
-    static constexpr float end_phase = 1.f;
-    float getSample() {
-        return samples.readAt(size * this->phase);
+    /**
+     * Build mip levels for num_tables consecutive tables of input
+     */
+    static void generateMips(FloatArray input, float* output, size_t num_tables) {
+        FastFourierTransform* fourier = FastFourierTransform::create(size);
+        ComplexFloatArray spectrum = ComplexFloatArray::create(size);
+        ComplexFloatArray tmp = ComplexFloatArray::create(size);
+        FloatArray wave = FloatArray::create(size);
+        for (size_t t = 0; t < num_tables; t++) {
+            wave.copyFrom(input.subArray(t * size, size));
+            fourier->fft(wave, spectrum); // destructive
+            for (size_t m = 0; m < num_mips; m++) {
+                size_t harmonics = size >> (m + 1);
+                tmp.copyFrom(spectrum);
+                for (size_t k = harmonics + 1; k < size - harmonics; k++) {
+                    tmp[k].re = 0.f;
+                    tmp[k].im = 0.f;
+                }
+                fourier->ifft(tmp, FloatArray(output, size));
+                output += size;
+            }
+        }
+        FloatArray::destroy(wave);
+        ComplexFloatArray::destroy(tmp);
+        ComplexFloatArray::destroy(spectrum);
+        FastFourierTransform::destroy(fourier);
     }
 
-    void generate(FloatArray input, FloatArray output) override {
-        OscillatorTemplate<WaveTableOscillator<size, dims, im>>::generate(input, output);
-        integrator.process(input, output);
+protected:
+    float* table_start;
+    float* table;
+    size_t mip = 0;
+    float mip_frac = 0.f;
+
+    static inline float read(const float* wave, size_t index, float frac) {
+        if constexpr (im == HERMITE_INTERPOLATION) {
+            float y0 = wave[(index - 1) & mask];
+            float y1 = wave[index & mask];
+            float y2 = wave[(index + 1) & mask];
+            float y3 = wave[(index + 2) & mask];
+            float c1 = 0.5f * (y2 - y0);
+            float c2 = y0 - 2.5f * y1 + 2.f * y2 - 0.5f * y3;
+            float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+            return ((c3 * frac + c2) * frac + c1) * frac + y1;
+        }
+        else if constexpr (im == LINEAR_INTERPOLATION) {
+            float y1 = wave[index & mask];
+            float y2 = wave[(index + 1) & mask];
+            return y1 + (y2 - y1) * frac;
+        }
+        else {
+            return wave[index & mask];
+        }
     }
 
-    void setFrequency(float freq) override {
-        OscillatorTemplate<WaveTableOscillator<size, dims, im>>::setFrequency(freq);
-        integrator.setCutoff(freq);
+    template <bool crossfade, bool with_fm>
+    void render(float* out, const float* fm, size_t len) {
+        const float* wave0 = table + mip * size;
+        const float* wave1 = table + (crossfade ? mip + 1 : mip) * size;
+        const float w = mip_frac;
+        const float inc = this->incr;
+        float ph = this->phase;
+        while (len--) {
+            float pos = ph * size;
+            size_t index = pos;
+            float frac = pos - index;
+            float sample = read(wave0, index, frac);
+            if constexpr (crossfade) {
+                float next = read(wave1, index, frac);
+                sample += (next - sample) * w;
+            }
+            *out++ = sample;
+            if constexpr (with_fm)
+                ph += inc * (1.f + *fm++);
+            else
+                ph += inc;
+            if (ph >= 1.f)
+                ph -= 1.f;
+            else if (ph < 0.f)
+                ph += 1.f;
+        }
+        this->phase = ph;
     }
-
-protected:
-    float* table_start;
-    Integrator integrator;
 };
 
 template <size_t size, size_t x_dim, size_t y_dim, InterpolationMethod im = LINEAR_INTERPOLATION>
 class WaveTableOscillator2D : public WaveTableOscillator<size, 2, im> {
 public:
+    using Base = WaveTableOscillator<size, 2, im>;
+    static constexpr size_t num_tables = x_dim * y_dim;
+
     WaveTableOscillator2D(float* data)
-        : WaveTableOscillator<size, 2, im>(data) {
+        : Base(data) {
     }
 
     void setTable(size_t x, size_t y) {
-        this->samples.setData(this->table_start + (y * y_dim + x) * size);
+        x = std::min(x, x_dim - 1);
+        y = std::min(y, y_dim - 1);
+        this->table = this->table_start + (y * x_dim + x) * Base::num_mips * size;
     }
 
+    /**
+     * Loads full bandwidth tables from a WAV resource and builds their mip
+     * levels
+     */
     static WaveTableOscillator2D* create(const char* name) {
         FloatArray samples = WavLoader::load(name);
-        if (samples.getSize() == x_dim * y_dim * size) {
-            return new WaveTableOscillator2D(samples.getData());
-        }
-        else {
+        if (samples.getSize() != num_tables * size) {
+            FloatArray::destroy(samples);
             return NULL;
         }
+        FloatArray mips = FloatArray::create(num_tables * Base::num_mips * size);
+        Base::generateMips(samples, mips.getData(), num_tables);
+        FloatArray::destroy(samples);
+        return new WaveTableOscillator2D(mips.getData());
     }
 
     static void destroy(WaveTableOscillator2D* table) {
-        delete[] table->table_start;
+        FloatArray::destroy(
+            FloatArray(table->table_start, num_tables * Base::num_mips * size));
         delete table;
     }
 };
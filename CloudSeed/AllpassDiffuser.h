@@ -1,53 +1,49 @@
+#ifndef ALLPASSDIFFUSER
+#define ALLPASSDIFFUSER
 
-#pragma once
-
-#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "FloatArray.h"
 #include "ModulatedAllpass.h"
 #include "AudioLib/ShaRandom.h"
-#include "SignalProcessor.h"
-
-using namespace std;
 
 namespace CloudSeed {
 
-class AllpassDiffuser : public SignalProcessor {
+/**
+ * Chain of up to MaxStageCount modulated allpass filters with seeded delays
+ */
+class AllpassDiffuser {
 public:
     static const int MaxStageCount = 2;
 
 private:
     int samplerate;
 
-    ModulatedAllpass** filters;
+    ModulatedAllpass* filters[MaxStageCount];
     int delay;
     float modRate;
-    vector<float> seedValues;
+    float seedValues[MaxStageCount * 3];
     int seed;
     float crossSeed;
 
 public:
     int Stages;
 
-    AllpassDiffuser(float samplerate, ModulatedAllpass** filters)
-        : filters(filters) {
-        crossSeed = 0.0;
-        seed = 23456;
+    AllpassDiffuser(int samplerate, ModulatedAllpass** filters)
+        : samplerate(samplerate)
+        , delay(100)
+        , modRate(0)
+        , seed(23456)
+        , crossSeed(0)
+        , Stages(1) {
+        std::copy(filters, filters + MaxStageCount, this->filters);
         UpdateSeeds();
-        Stages = 1;
-
-        SetSamplerate(samplerate);
     }
 
-    ~AllpassDiffuser() {}
-
     int GetSamplerate() {
         return samplerate;
     }
 
-    void SetSamplerate(int samplerate) {
-        this->samplerate = samplerate;
-        SetModRate(modRate);
-    }
-
     void SetSeed(int seed) {
         this->seed = seed;
         UpdateSeeds();
@@ -72,10 +68,6 @@ public:
             filter->InterpolationEnabled = enabled;
     }
 
-    float* GetOutput() {
-        return filters[Stages - 1]->GetOutput();
-    }
-
     void SetDelay(int delaySamples) {
         delay = delaySamples;
         Update();
@@ -87,7 +79,7 @@ public:
     }
 
     void SetModAmount(float amount) {
-        for (int i = 0; i < filters.size(); i++) {
+        for (int i = 0; i < MaxStageCount; i++) {
             filters[i]->ModAmount =
                 amount * (0.85 + 0.3 * seedValues[MaxStageCount + i]);
         }
@@ -96,56 +88,56 @@ public:
     void SetModRate(float rate) {
         modRate = rate;
 
-        for (size_t i = 0; i < filters.size(); i++)
+        for (int i = 0; i < MaxStageCount; i++)
             filters[i]->ModRate = rate *
                 (0.85 + 0.3 * seedValues[MaxStageCount * 2 + i]) / samplerate;
     }
 
+    /**
+     * Process a block, input and output may be the same array
+     */
     void process(FloatArray input, FloatArray output) {
-        ModulatedAllpass** filterPtr = &filters[0];
-
-        filterPtr[0]->process(input, output);
+        filters[0]->process(input, output);
 
         for (int i = 1; i < Stages; i++) {
-            filterPtr[i]->process(output, output);
+            filters[i]->process(output, output);
         }
     }
 
     void ClearBuffers() {
-        for (size_t i = 0; i < filters.size(); i++)
-            filters[i]->ClearBuffers();
+        for (auto filter : filters)
+            filter->ClearBuffers();
     }
 
-    static AllpassDiffuser* create(float sr, int delayBufferLengthMillis) {
-        auto delayBufferSize = samplerate * ((float)delayBufferLengthMillis / 1000.0);
-        ModulatedAllpass** filters = new ModulateAllpass*[MaxStageCount];
+    static AllpassDiffuser* create(int samplerate, int delayBufferLengthMillis) {
+        int delayBufferSize = samplerate * ((float)delayBufferLengthMillis / 1000.0);
+        ModulatedAllpass* filters[MaxStageCount];
         for (int i = 0; i < MaxStageCount; i++) {
-            filters[i] = ModulatedAllpass::create((int)delayBufferSize, 100);
+            filters[i] = ModulatedAllpass::create(delayBufferSize, 100);
         }
-        return new AllpassDiffuser(sr, delayBufferLengthMillis, filters);
+        return new AllpassDiffuser(samplerate, filters);
     }
 
 	static void destroy(AllpassDiffuser* diffuser) {
-		for (int i = 0; i < MaxStageCount; i++) {
-			ModulatedAllpass::destroy(diffuser->filters[i]);
-			delete diffuser::filters;
+        for (auto filter : diffuser->filters)
+            ModulatedAllpass::destroy(filter);
 			delete diffuser;
-		}
 	}
 
 private:
     void Update() {
-        for (size_t i = 0; i < filters.size(); i++) {
-            auto r = seedValues[i];
-            auto d = pow(10, r) * 0.1; // 0.1 ... 1.0
+        for (int i = 0; i < MaxStageCount; i++) {
+            float r = seedValues[i];
+            float d = std::pow(10, r) * 0.1; // 0.1 ... 1.0
             filters[i]->SampleDelay = (int)(delay * d);
         }
     }
 
     void UpdateSeeds() {
-        this->seedValues =
-            AudioLib::ShaRandom::Generate(seed, MaxStageCount * 3, crossSeed);
+        AudioLib::ShaRandom::Generate(seed, seedValues, MaxStageCount * 3, crossSeed);
         Update();
     }
 };
 }
+
+#endif
@@ -0,0 +1,341 @@
+#ifndef AUDIOLIB_FACTORYSEEDS
+#define AUDIOLIB_FACTORYSEEDS
+
+namespace AudioLib
+{
+	/**
+	 * SHA-256 random series for seeds used by CloudSeed factory presets,
+	 * including inverted seeds used for cross seed. Values are identical to
+	 * ShaRandom::Generate() with Algorithm::Sha256, so presets sound the
+	 * same without hashing at runtime. Tap seeds have 100 values, others 6.
+	 */
+	struct FactorySeries
+	{
+		long long seed;
+		int count;
+		const float* values;
+	};
+
+	static constexpr float FactorySeed_m1151[100] = {
+		0.789808393f, 0.396300197f, 0.0508960038f, 0.802317441f, 0.168993428f, 0.246472597f,
+		0.670155644f, 0.342928916f, 0.465218455f, 0.460497618f, 0.612883925f, 0.978461802f,
+		0.759990513f, 0.206719145f, 0.961569071f, 0.858334303f, 0.706354737f, 0.942064047f,
+		0.643163741f, 0.378223091f, 0.0513489358f, 0.635944784f, 0.427516401f, 0.422571898f,
+		0.205309227f, 0.0382673927f, 0.223840877f, 0.0210976265f, 0.179526851f, 0.861438215f,
+		0.671903908f, 0.909953594f, 0.931046844f, 0.169879004f, 0.672202408f, 0.989374936f,
+		0.585557938f, 0.380239099f, 0.00481407857f, 0.618616104f, 0.407060683f, 0.9105708f,
+		0.459784865f, 0.352745205f, 0.374582499f, 0.321043044f, 0.0191562772f, 0.446749657f,
+		0.616537273f, 0.317216933f, 0.915264308f, 0.216977373f, 0.145514384f, 0.0361891203f,
+		0.425710648f, 0.708562553f, 0.523648024f, 0.823810518f, 0.359659433f, 0.180706501f,
+		0.180990845f, 0.913517594f, 0.00510046445f, 0.037058901f, 0.557289422f, 0.355387777f,
+		0.305415154f, 0.925580621f, 0.314087421f, 0.0451050065f, 0.936739624f, 0.956438661f,
+		0.251676202f, 0.503412843f, 0.308454424f, 0.928245902f, 0.208842352f, 0.928646564f,
+		0.687341392f, 0.565747797f, 0.344804555f, 0.0779307783f, 0.0570766144f, 0.114269994f,
+		0.938848376f, 0.378424227f, 0.839211047f, 0.539998293f, 0.823231459f, 0.956963301f,
+		0.967278123f, 0.181209579f, 0.0218388792f, 0.568895042f, 0.0687004775f, 0.407773018f,
+		0.737035394f, 0.685922861f, 0.0653496608f, 0.853230596f
+	};
+
+	static constexpr float FactorySeed_m1003[6] = {
+		0.936046898f, 0.212266907f, 0.807032049f, 0.662680268f, 0.77802515f, 0.276125103f
+	};
+
+	static constexpr float FactorySeed_m745[6] = {
+		0.234847799f, 0.410164326f, 0.0129541093f, 0.267199486f, 0.258104682f, 0.1819233f
+	};
+
+	static constexpr float FactorySeed_m502[6] = {
+		0.442125052f, 0.301413834f, 0.648652315f, 0.151695624f, 0.590127945f, 0.309147477f
+	};
+
+	static constexpr float FactorySeed_m486[100] = {
+		0.355015397f, 0.805683255f, 0.914690495f, 0.518008411f, 0.166370615f, 0.371352613f,
+		0.930666089f, 0.183298528f, 0.344005227f, 0.928691149f, 0.319391221f, 0.78148526f,
+		0.947499514f, 0.855952263f, 0.837196469f, 0.381106794f, 0.478215098f, 0.113248169f,
+		0.382766336f, 0.0457811654f, 0.994867861f, 0.914040685f, 0.16224052f, 0.672152996f,
+		0.653958499f, 0.414949775f, 0.783454955f, 0.656852663f, 0.0339703709f, 0.549066067f,
+		0.56096971f, 0.410520524f, 0.364441723f, 0.724706709f, 0.316357374f, 0.168643638f,
+		0.0164054204f, 0.769061327f, 0.367486507f, 0.549799919f, 0.256945878f, 0.00663045608f,
+		0.631227255f, 0.579948246f, 0.304427028f, 0.386256844f, 0.556496322f, 0.703892469f,
+		0.759398103f, 0.997545779f, 0.602755189f, 0.348306656f, 0.201658934f, 0.58005023f,
+		0.928772271f, 0.524810314f, 0.707592249f, 0.840825319f, 0.817040026f, 0.613035321f,
+		0.45016855f, 0.0381026976f, 0.764408529f, 0.112419412f, 0.00833382271f, 0.525594354f,
+		0.336650014f, 0.599825501f, 0.673934937f, 0.415716499f, 0.157772347f, 0.532216311f,
+		0.813569248f, 0.0600984544f, 0.022897033f, 0.148739144f, 0.220383704f, 0.566576719f,
+		0.0295741428f, 0.799712956f, 0.655875206f, 0.341699779f, 0.143700391f, 0.108592309f,
+		0.98532486f, 0.362930864f, 0.813958824f, 0.0174618065f, 0.411072195f, 0.815030158f,
+		0.68113029f, 0.24201718f, 0.902965486f, 0.52948606f, 0.528476357f, 0.657670736f,
+		0.524177313f, 0.579941869f, 0.143344283f, 0.121186033f
+	};
+
+	static constexpr float FactorySeed_m373[6] = {
+		0.498460144f, 0.236282676f, 0.74329704f, 0.0768498927f, 0.25642994f, 0.855077147f
+	};
+
+	static constexpr float FactorySeed_m348[6] = {
+		0.924265504f, 0.236226872f, 0.569306195f, 0.220821366f, 0.135997087f, 0.245399296f
+	};
+
+	static constexpr float FactorySeed_m338[6] = {
+		0.0561260171f, 0.866010249f, 0.510329068f, 0.687137246f, 0.151590481f, 0.888693333f
+	};
+
+	static constexpr float FactorySeed_m336[6] = {
+		0.0220913291f, 0.239037305f, 0.323699534f, 0.402748436f, 0.829595387f, 0.752596438f
+	};
+
+	static constexpr float FactorySeed_m302[100] = {
+		0.55271101f, 0.82728821f, 0.300903589f, 0.933958054f, 0.854520857f, 0.501542568f,
+		0.540001452f, 0.297291249f, 0.364663839f, 0.720765412f, 0.396457791f, 0.875042498f,
+		0.0938974172f, 0.846112192f, 0.241547704f, 0.473603457f, 0.532508194f, 0.937903225f,
+		0.213222191f, 0.575800121f, 0.57750541f, 0.800006509f, 0.537940562f, 0.168480009f,
+		0.175017506f, 0.975257576f, 0.579346299f, 0.397984385f, 0.675088584f, 0.553246915f,
+		0.140102506f, 0.188980177f, 0.461625546f, 0.200008526f, 0.0908917785f, 0.0705608726f,
+		0.00458158832f, 0.661028206f, 0.92204839f, 0.742519975f, 0.633439124f, 0.399291217f,
+		0.688251376f, 0.232721955f, 0.457403183f, 0.341935515f, 0.319543213f, 0.323307902f,
+		0.958634675f, 0.616153002f, 0.274866253f, 0.688170075f, 0.638045073f, 0.812169135f,
+		0.86631465f, 0.244884491f, 0.920207202f, 0.667305291f, 0.0437933542f, 0.235576168f,
+		0.273643494f, 0.583905876f, 0.915905774f, 0.429091156f, 0.386008471f, 0.57991308f,
+		0.431180775f, 0.752529144f, 0.820313275f, 0.00236274861f, 0.345899701f, 0.0367281921f,
+		0.261198938f, 0.162673399f, 0.884420097f, 0.933848143f, 0.548518956f, 0.479337513f,
+		0.350865901f, 0.347328961f, 0.640082657f, 0.366521478f, 0.113040514f, 0.751283169f,
+		0.412024766f, 0.936949313f, 0.102183908f, 0.420910448f, 0.530696392f, 0.711942971f,
+		0.180067271f, 0.0865725949f, 0.906662941f, 0.543438971f, 0.859168172f, 0.554152608f,
+		0.575062454f, 0.639657915f, 0.151600271f, 0.370823473f
+	};
+
+	static constexpr float FactorySeed_m274[6] = {
+		0.934277773f, 0.990933955f, 0.246297941f, 0.260962546f, 0.124017976f, 0.216857851f
+	};
+
+	static constexpr float FactorySeed_m209[6] = {
+		0.0269753169f, 0.540494621f, 0.812798798f, 0.0468687788f, 0.245536014f, 0.0784320384f
+	};
+
+	static constexpr float FactorySeed_m190[6] = {
+		0.583873272f, 0.486282527f, 0.158051923f, 0.0938857496f, 0.260884255f, 0.523531139f
+	};
+
+	static constexpr float FactorySeed_m182[6] = {
+		0.18241787f, 0.618971229f, 0.599725068f, 0.712228239f, 0.727748513f, 0.938216209f
+	};
+
+	static constexpr float FactorySeed_m171[6] = {
+		0.255438536f, 0.122026324f, 0.920691311f, 0.219090104f, 0.419855028f, 0.824724376f
+	};
+
+	static constexpr float FactorySeed_m162[6] = {
+		0.186754867f, 0.0229219627f, 0.191782624f, 0.478553683f, 0.949495316f, 0.338676184f
+	};
+
+	static constexpr float FactorySeed_m157[6] = {
+		0.575639188f, 0.516498327f, 0.871774435f, 0.90762943f, 0.494065106f, 0.562328577f
+	};
+
+	static constexpr float FactorySeed_m115[100] = {
+		0.330065936f, 0.83425343f, 0.25588578f, 0.0853989422f, 0.130936086f, 0.785460949f,
+		0.889573872f, 0.460139722f, 0.605582535f, 0.263498783f, 0.153241605f, 0.548520267f,
+		0.786683321f, 0.212351963f, 0.827726781f, 0.0469026305f, 0.747166097f, 0.508550704f,
+		0.94184196f, 0.383295506f, 0.750594556f, 0.791591763f, 0.907734454f, 0.255018115f,
+		0.896756411f, 0.588163853f, 0.738807023f, 0.980884016f, 0.17950432f, 0.421168596f,
+		0.264007479f, 0.193868309f, 0.0681644976f, 0.739559054f, 0.250502288f, 0.0168305598f,
+		0.11353977f, 0.480650395f, 0.814544261f, 0.765993834f, 0.85133034f, 0.859175622f,
+		0.504021823f, 0.00602278812f, 0.944660187f, 0.150637329f, 0.805351317f, 0.53513962f,
+		0.402669966f, 0.663982809f, 0.78881973f, 0.172427863f, 0.287316114f, 0.431504101f,
+		0.0317982063f, 0.723181605f, 0.077556923f, 0.00814241916f, 0.672566891f, 0.182868302f,
+		0.160918474f, 0.146965697f, 0.170212701f, 0.249097541f, 0.628573596f, 0.903123856f,
+		0.795486808f, 0.853640497f, 0.213410378f, 0.38830632f, 0.82352668f, 0.173702016f,
+		0.0709460154f, 0.301620096f, 0.775315702f, 0.127743587f, 0.897034526f, 0.581045806f,
+		0.757258356f, 0.424109578f, 0.880772352f, 0.609795034f, 0.978357732f, 0.282584369f,
+		0.912672818f, 0.0270340312f, 0.579015136f, 0.824500144f, 0.677584589f, 0.284882784f,
+		0.27215293f, 0.0456727892f, 0.666079402f, 0.685504615f, 0.732729375f, 0.430894256f,
+		0.851425052f, 0.560885429f, 0.370878488f, 0.620918274f
+	};
+
+	static constexpr float FactorySeed_m86[6] = {
+		0.308388025f, 0.59494555f, 0.786962926f, 0.352464646f, 0.332453042f, 0.154376596f
+	};
+
+	static constexpr float FactorySeed_85[6] = {
+		0.284544528f, 0.297427058f, 0.751154065f, 0.0478976741f, 0.177870601f, 0.389664114f
+	};
+
+	static constexpr float FactorySeed_114[100] = {
+		0.164781004f, 0.618368924f, 0.0176947918f, 0.406304479f, 0.563576043f, 0.297837317f,
+		0.265556782f, 0.0397384539f, 0.962935746f, 0.712198436f, 0.609656215f, 0.387767643f,
+		0.203557655f, 0.660962522f, 0.632918835f, 0.801069617f, 0.989507139f, 0.7931903f,
+		0.690061927f, 0.967609823f, 0.745508611f, 0.354392916f, 0.626720428f, 0.0166730452f,
+		0.929521739f, 0.885418177f, 0.385472864f, 0.485601544f, 0.968160748f, 0.676920772f,
+		0.909162581f, 0.0801773816f, 0.968260944f, 0.813841283f, 0.417836517f, 0.458361775f,
+		0.751652598f, 0.793565452f, 0.266145945f, 0.108171366f, 0.109264381f, 0.893236816f,
+		0.555555642f, 0.603753328f, 0.607566118f, 0.901520431f, 0.915071905f, 0.270837873f,
+		0.797520638f, 0.0240862388f, 0.515179038f, 0.976553321f, 0.963594973f, 0.182066336f,
+		0.888897359f, 0.405650347f, 0.994307041f, 0.889058888f, 0.845068097f, 0.992226183f,
+		0.148157492f, 0.562696099f, 0.604923487f, 0.870681584f, 0.382761776f, 0.65096581f,
+		0.0624923557f, 0.103013635f, 0.689275384f, 0.0514205135f, 0.78875196f, 0.586452961f,
+		0.641748071f, 0.269554824f, 0.907868326f, 0.623634219f, 0.095160082f, 0.930139005f,
+		0.450837165f, 0.206145167f, 0.356681466f, 0.345829636f, 0.571867406f, 0.687405944f,
+		0.628378093f, 0.135653436f, 0.873781264f, 0.406553358f, 0.800811112f, 0.228310719f,
+		0.301167041f, 0.0621610284f, 0.209836677f, 0.383529067f, 0.0285340175f, 0.818903327f,
+		0.855638206f, 0.0237080026f, 0.581857026f, 0.0189796444f
+	};
+
+	static constexpr float FactorySeed_156[6] = {
+		0.422574401f, 0.305592209f, 0.54932791f, 0.173898712f, 0.588463485f, 0.408427268f
+	};
+
+	static constexpr float FactorySeed_161[6] = {
+		0.838526487f, 0.37948668f, 0.933314741f, 0.731478095f, 0.71317476f, 0.472218513f
+	};
+
+	static constexpr float FactorySeed_170[6] = {
+		0.00200187601f, 0.369019479f, 0.148739085f, 0.187106788f, 0.208775789f, 0.763387084f
+	};
+
+	static constexpr float FactorySeed_181[6] = {
+		0.631290376f, 0.691103578f, 0.470797867f, 0.818877459f, 0.437183857f, 0.903844535f
+	};
+
+	static constexpr float FactorySeed_189[6] = {
+		0.268315047f, 0.558827221f, 0.634809852f, 0.801899612f, 0.370365947f, 0.736835659f
+	};
+
+	static constexpr float FactorySeed_208[6] = {
+		0.792921245f, 0.756943822f, 0.609028101f, 0.614986181f, 0.271522403f, 0.138423055f
+	};
+
+	static constexpr float FactorySeed_273[6] = {
+		0.0754563585f, 0.396275163f, 0.484651089f, 0.615906537f, 0.122806802f, 0.832746685f
+	};
+
+	static constexpr float FactorySeed_301[100] = {
+		0.929905236f, 0.704842925f, 0.0108993668f, 0.286075294f, 0.381954044f, 0.143799081f,
+		0.536042929f, 0.87434715f, 0.745659292f, 0.00363410474f, 0.541637063f, 0.00327251479f,
+		0.886433542f, 0.954120934f, 0.684889615f, 0.162826985f, 0.505520225f, 0.115700357f,
+		0.861538231f, 0.871014059f, 0.590258837f, 0.625194192f, 0.28689447f, 0.303565264f,
+		0.518998146f, 0.906004429f, 0.472891241f, 0.75610894f, 0.342473567f, 0.667566955f,
+		0.03962484f, 0.831077635f, 0.582836092f, 0.366639078f, 0.558753133f, 0.471496135f,
+		0.46649316f, 0.642570794f, 0.00958527252f, 0.240221381f, 0.250087649f, 0.71770376f,
+		0.289864331f, 0.268163383f, 0.140309423f, 0.642360449f, 0.207443938f, 0.698322117f,
+		0.427596658f, 0.758365333f, 0.311886996f, 0.830183327f, 0.504972756f, 0.0429574363f,
+		0.245310843f, 0.0689967275f, 0.838839352f, 0.950604796f, 0.748606026f, 0.640150487f,
+		0.228292495f, 0.385516018f, 0.357696831f, 0.955250978f, 0.655309975f, 0.883427501f,
+		0.51357162f, 0.173820049f, 0.683588982f, 0.346723676f, 0.299548984f, 0.96667099f,
+		0.475180268f, 0.229929671f, 0.675282061f, 0.876577914f, 0.401616156f, 0.988830805f,
+		0.25606212f, 0.510738313f, 0.973561823f, 0.216044709f, 0.489294738f, 0.245696902f,
+		0.85620743f, 0.889723659f, 0.654557467f, 0.484416455f, 0.40553391f, 0.505998254f,
+		0.198777318f, 0.516643167f, 0.718354821f, 0.266972005f, 0.43101576f, 0.0130488575f,
+		0.560469925f, 0.881753981f, 0.828098297f, 0.686267495f
+	};
+
+	static constexpr float FactorySeed_335[6] = {
+		0.791780591f, 0.407825917f, 0.522465467f, 0.0376337208f, 0.946901739f, 0.579341948f
+	};
+
+	static constexpr float FactorySeed_337[6] = {
+		0.997861207f, 0.990214765f, 0.875370741f, 0.67891109f, 0.370981842f, 0.140609279f
+	};
+
+	static constexpr float FactorySeed_347[6] = {
+		0.442984998f, 0.911150634f, 0.683301389f, 0.176249519f, 0.211612478f, 0.0206684787f
+	};
+
+	static constexpr float FactorySeed_372[6] = {
+		0.267527282f, 0.284180582f, 0.78213197f, 0.721778274f, 0.818729997f, 0.924865603f
+	};
+
+	static constexpr float FactorySeed_485[100] = {
+		0.196708813f, 0.948437512f, 0.256667554f, 0.351519644f, 0.284252107f, 0.665349185f,
+		0.833909571f, 0.809269547f, 0.994393945f, 0.41307497f, 0.986353755f, 0.0908909813f,
+		0.303383708f, 0.533719063f, 0.110278286f, 0.91336143f, 0.938698411f, 0.517502308f,
+		0.963678658f, 0.197348699f, 0.417986333f, 0.376882464f, 0.705774486f, 0.834767938f,
+		0.726548195f, 0.982914209f, 0.214793488f, 0.0116895968f, 0.531728685f, 0.817733347f,
+		0.10251721f, 0.460266709f, 0.290870249f, 0.390871286f, 0.959864974f, 0.526037991f,
+		0.426667392f, 0.400032252f, 0.401626647f, 0.228006884f, 0.100683898f, 0.905423045f,
+		0.227882132f, 0.207450598f, 0.758184373f, 0.394959152f, 0.406914771f, 0.505714774f,
+		0.16735822f, 0.648881972f, 0.150516286f, 0.581426144f, 0.687406659f, 0.389847577f,
+		0.0349992514f, 0.4204714f, 0.609087586f, 0.301992774f, 0.890619516f, 0.498393565f,
+		0.147943512f, 0.348409504f, 0.872419357f, 0.817247272f, 0.976622283f, 0.612934887f,
+		0.590069652f, 0.63632369f, 0.157788023f, 0.0808395669f, 0.872887254f, 0.602685928f,
+		0.72430861f, 0.0101903249f, 0.0625907108f, 0.396070093f, 0.431520194f, 0.703121185f,
+		0.746245325f, 0.164241955f, 0.839695513f, 0.616759896f, 0.188893229f, 0.849074185f,
+		0.487208933f, 0.220703423f, 0.0320118777f, 0.33962816f, 0.363616943f, 0.22489655f,
+		0.947270393f, 0.25056079f, 0.0787272379f, 0.0957848504f, 0.582065642f, 0.229203746f,
+		0.322343796f, 0.537599564f, 0.841945946f, 0.338964224f
+	};
+
+	static constexpr float FactorySeed_501[6] = {
+		0.794436872f, 0.524726868f, 0.0176235773f, 0.14043431f, 0.240650341f, 0.82267499f
+	};
+
+	static constexpr float FactorySeed_744[6] = {
+		0.117098138f, 0.639484167f, 0.967856824f, 0.442288935f, 0.922176838f, 0.654273629f
+	};
+
+	static constexpr float FactorySeed_1002[6] = {
+		0.782006025f, 0.554616511f, 0.364180148f, 0.0584962368f, 0.0952063575f, 0.105931111f
+	};
+
+	static constexpr float FactorySeed_1150[100] = {
+		0.343817711f, 0.288978904f, 0.186916664f, 0.47570616f, 0.930938303f, 0.660381496f,
+		0.184491396f, 0.611545503f, 0.728731573f, 0.248908788f, 0.661972106f, 0.333794564f,
+		0.107838206f, 0.133006498f, 0.922972143f, 0.18815057f, 0.131880313f, 0.860124588f,
+		0.507642806f, 0.0519671328f, 0.393232763f, 0.806643248f, 0.707137704f, 0.319041133f,
+		0.975378931f, 0.312264472f, 0.362946033f, 0.0188660603f, 0.637874067f, 0.264367372f,
+		0.577670574f, 0.679955006f, 0.983995855f, 0.0676467717f, 0.194082856f, 0.660415649f,
+		0.239836305f, 0.0318527222f, 0.513189137f, 0.803139806f, 0.093466267f, 0.449504524f,
+		0.784428f, 0.756106853f, 0.304561973f, 0.805095255f, 0.679233491f, 0.417868286f,
+		0.373636514f, 0.497166455f, 0.887305498f, 0.574029386f, 0.374838412f, 0.158358768f,
+		0.480734944f, 0.521308899f, 0.263330609f, 0.0421695374f, 0.880209684f, 0.442485422f,
+		0.579351783f, 0.823015332f, 0.533628762f, 0.307446957f, 0.765691698f, 0.891451478f,
+		0.327165276f, 0.243784249f, 0.138873369f, 0.552504778f, 0.478036463f, 0.74687171f,
+		0.268031329f, 0.241355717f, 0.207891658f, 0.309321523f, 0.915563822f, 0.357367367f,
+		0.993494213f, 0.440161496f, 0.993045688f, 0.0794189051f, 0.0139449369f, 0.0284592044f,
+		0.212071285f, 0.274774522f, 0.538878083f, 0.272020489f, 0.972193837f, 0.0717966035f,
+		0.546848655f, 0.704534233f, 0.10185948f, 0.509855986f, 0.478752881f, 0.233083501f,
+		0.696150422f, 0.577014685f, 0.237132862f, 0.215315327f
+	};
+
+	static constexpr FactorySeries FactorySeeds[] = {
+		{ -1151, 100, FactorySeed_m1151 },
+		{ -1003, 6, FactorySeed_m1003 },
+		{ -745, 6, FactorySeed_m745 },
+		{ -502, 6, FactorySeed_m502 },
+		{ -486, 100, FactorySeed_m486 },
+		{ -373, 6, FactorySeed_m373 },
+		{ -348, 6, FactorySeed_m348 },
+		{ -338, 6, FactorySeed_m338 },
+		{ -336, 6, FactorySeed_m336 },
+		{ -302, 100, FactorySeed_m302 },
+		{ -274, 6, FactorySeed_m274 },
+		{ -209, 6, FactorySeed_m209 },
+		{ -190, 6, FactorySeed_m190 },
+		{ -182, 6, FactorySeed_m182 },
+		{ -171, 6, FactorySeed_m171 },
+		{ -162, 6, FactorySeed_m162 },
+		{ -157, 6, FactorySeed_m157 },
+		{ -115, 100, FactorySeed_m115 },
+		{ -86, 6, FactorySeed_m86 },
+		{ 85, 6, FactorySeed_85 },
+		{ 114, 100, FactorySeed_114 },
+		{ 156, 6, FactorySeed_156 },
+		{ 161, 6, FactorySeed_161 },
+		{ 170, 6, FactorySeed_170 },
+		{ 181, 6, FactorySeed_181 },
+		{ 189, 6, FactorySeed_189 },
+		{ 208, 6, FactorySeed_208 },
+		{ 273, 6, FactorySeed_273 },
+		{ 301, 100, FactorySeed_301 },
+		{ 335, 6, FactorySeed_335 },
+		{ 337, 6, FactorySeed_337 },
+		{ 347, 6, FactorySeed_347 },
+		{ 372, 6, FactorySeed_372 },
+		{ 485, 100, FactorySeed_485 },
+		{ 501, 6, FactorySeed_501 },
+		{ 744, 6, FactorySeed_744 },
+		{ 1002, 6, FactorySeed_1002 },
+		{ 1150, 100, FactorySeed_1150 }
+	};
+}
+
+#endif
@@ -21,6 +21,7 @@ namespace AudioLib
 		{
 			this->lpOut = 0;
 			this->fs = fs;
+			this->Output = 0;
 		}
 
 		float GetSamplerate()
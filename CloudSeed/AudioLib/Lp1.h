@@ -17,6 +17,7 @@ namespace AudioLib
 		Lp1(float fs)
 		{
 			this->fs = fs;
+			this->Output = 0;
 		}
 
 		float GetSamplerate()
@@ -1,15 +1,144 @@
 #ifndef SHARANDOM
 #define SHARANDOM
 
-#include <vector>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include "Sha256.h"
+#include "FactorySeeds.h"
 
 namespace AudioLib
 {
+	/**
+	 * Deterministic random series in 0..1 range used to expand seed
+	 * parameters. Output is written to caller provided arrays and nothing is
+	 * allocated, so seeds can be changed from the audio thread.
+	 *
+	 * Original CloudSeed hashes seeds with SHA-256. Series for seeds used by
+	 * factory presets are precomputed in FactorySeeds.h, so presets sound the
+	 * same. Other seeds use a cheap splitmix64 generator, unless
+	 * CLOUDSEED_SHA_RANDOM is defined - then SHA-256 is computed for them.
+	 */
 	class ShaRandom
 	{
 	public:
-		static std::vector<float> Generate(long long seed, int count);
-		static std::vector<float> Generate(long long seed, int count, float crossSeed);
+		enum class Algorithm
+		{
+			Sha256,
+			SplitMix
+		};
+
+#ifdef CLOUDSEED_SHA_RANDOM
+		static constexpr Algorithm DefaultAlgorithm = Algorithm::Sha256;
+#else
+		static constexpr Algorithm DefaultAlgorithm = Algorithm::SplitMix;
+#endif
+
+		static void Generate(long long seed, float* output, int count)
+		{
+			Series series(seed, count, DefaultAlgorithm);
+			for (int i = 0; i < count; i++)
+				output[i] = series.Next();
+		}
+
+		/**
+		 * Series for seed crossfaded with series for inverted seed
+		 */
+		static void Generate(long long seed, float* output, int count, float crossSeed)
+		{
+			if (crossSeed == 0)
+			{
+				Generate(seed, output, count);
+				return;
+			}
+			Series seriesA(seed, count, DefaultAlgorithm);
+			Series seriesB(~seed, count, DefaultAlgorithm);
+			for (int i = 0; i < count; i++)
+				output[i] = seriesA.Next() * (1 - crossSeed) + seriesB.Next() * crossSeed;
+		}
+
+		/**
+		 * Generate series with given algorithm, ignoring factory table
+		 */
+		static void Generate(long long seed, float* output, int count, Algorithm algorithm)
+		{
+			Series series(seed, 0, algorithm);
+			for (int i = 0; i < count; i++)
+				output[i] = series.Next();
+		}
+
+	private:
+		/**
+		 * Streaming generator. Factory table is used if it covers count values,
+		 * otherwise values are generated on the fly.
+		 */
+		class Series
+		{
+		private:
+			const float* table;
+			Algorithm algorithm;
+			uint64_t state;
+			uint32_t pending;
+			unsigned char digest[32];
+			int position;
+
+		public:
+			Series(long long seed, int count, Algorithm algorithm)
+				: table(nullptr)
+				, algorithm(algorithm)
+				, state((uint64_t)seed)
+				, pending(0)
+				, position(0)
+			{
+				for (const FactorySeries& series : FactorySeeds)
+				{
+					if (series.seed == seed && count <= series.count)
+					{
+						table = series.values;
+						break;
+					}
+				}
+				// SHA-256 series hashes first 8 bytes of previous digest,
+				// starting with the seed itself
+				std::memset(digest, 0, sizeof(digest));
+				std::memcpy(digest, &seed, 8);
+			}
+
+			float Next()
+			{
+				if (table != nullptr)
+					return table[position++];
+
+				uint32_t val;
+				if (algorithm == Algorithm::Sha256)
+				{
+					// Each digest gives 8 values
+					int index = position++ & 7;
+					if (index == 0)
+						sha256(digest, 8, digest);
+					std::memcpy(&val, digest + index * 4, 4);
+				}
+				else
+				{
+					// Each splitmix64 step gives 2 values
+					if ((position++ & 1) == 0)
+					{
+						state += 0x9e3779b97f4a7c15ull;
+						uint64_t z = state;
+						z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+						z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+						z = z ^ (z >> 31);
+						val = (uint32_t)z;
+						pending = (uint32_t)(z >> 32);
+					}
+					else
+					{
+						val = pending;
+					}
+				}
+				return val / (float)UINT_MAX;
+			}
+		};
 	};
 }
 
@@ -1,38 +1,87 @@
 #ifndef AUDIOLIB_VALUETABLES
 #define AUDIOLIB_VALUETABLES
 
-#include "MathDefs.h"
-
+#include <cmath>
 
 namespace AudioLib
 {
+	/**
+	 * Parameter response curves. These used to be 15 lookup tables of
+	 * 40001 floats each filled at startup, but only 4001 entries were
+	 * ever used and lookups only happen on parameter changes. Curves are
+	 * now evaluated directly at the same 4001 steps, so results match the
+	 * old tables while using no memory and no initialisation.
+	 */
 	class ValueTables
 	{
 	public:
-		static const int TableSize = 40001;
-
-		static DSY_SDRAM_BSS float Sqrt[TableSize];
-		static DSY_SDRAM_BSS float Sqrt3[TableSize];
-		static DSY_SDRAM_BSS float Pow1_5[TableSize];
-		static DSY_SDRAM_BSS float Pow2[TableSize];
-		static DSY_SDRAM_BSS float Pow3[TableSize];
-		static DSY_SDRAM_BSS float Pow4[TableSize];
-		static DSY_SDRAM_BSS float x2Pow3[TableSize];
-
-		// octave response. value float every step (2,3,4,5 or 6 steps)
-		static DSY_SDRAM_BSS float Response2Oct[TableSize];
-		static DSY_SDRAM_BSS float Response3Oct[TableSize];
-		static DSY_SDRAM_BSS float Response4Oct[TableSize];
-		static DSY_SDRAM_BSS float Response5Oct[TableSize];
-		static DSY_SDRAM_BSS float Response6Oct[TableSize];
-
-		// decade response, value multiplies by 10 every step
-		static DSY_SDRAM_BSS float Response2Dec[TableSize];
-		static DSY_SDRAM_BSS float Response3Dec[TableSize];
-		static DSY_SDRAM_BSS float Response4Dec[TableSize];
-
-		static void Init();
-		static float Get(float index, float* table);
+		static constexpr int TableSize = 4001;
+
+		enum Table
+		{
+			Sqrt,
+			Sqrt3,
+			Pow1_5,
+			Pow2,
+			Pow3,
+			Pow4,
+			x2Pow3,
+
+			// octave response. value float every step (2,3,4,5 or 6 steps)
+			Response2Oct,
+			Response3Oct,
+			Response4Oct,
+			Response5Oct,
+			Response6Oct,
+
+			// decade response, value multiplies by 10 every step
+			Response2Dec,
+			Response3Dec,
+			Response4Dec
+		};
+
+		static float Get(float index, Table table)
+		{
+			int idx = (int)(index * 4000.999);
+			if (idx < 0)
+				idx = 0;
+			else if (idx >= TableSize)
+				idx = TableSize - 1;
+			float x = idx / 4000.0f;
+
+			switch (table)
+			{
+			case Sqrt:         return std::sqrt(x);
+			case Sqrt3:        return std::cbrt(x);
+			case Pow1_5:       return x * std::sqrt(x);
+			case Pow2:         return x * x;
+			case Pow3:         return x * x * x;
+			case Pow4:         return (x * x) * (x * x);
+			case x2Pow3:       return 8 * x * x * x;
+			case Response2Oct: return Response(x, 4);
+			case Response3Oct: return Response(x, 8);
+			case Response4Oct: return Response(x, 16);
+			case Response5Oct: return Response(x, 32);
+			case Response6Oct: return Response(x, 64);
+			case Response2Dec: return Response(x, 100);
+			case Response3Dec: return Response(x, 1000);
+			case Response4Dec: return Response(x, 10000);
+			}
+			return x;
+		}
+
+	private:
+		/**
+		 * Exponential curve normalized to 0..1 range. Octave and decade
+		 * tables were built with offsets that cancel after normalization,
+		 * leaving (range^x - 1) / (range - 1).
+		 */
+		static float Response(float x, float range)
+		{
+			if (x == 0)
+				return 0;
+			return (std::exp(x * std::log(range)) - 1) / (range - 1);
+		}
 	};
 }
 
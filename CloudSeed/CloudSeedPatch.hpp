@@ -0,0 +1,65 @@
+#include "Patch.h"
+#include "ReverbController.h"
+
+#define P_DECAY PARAMETER_A
+#define P_SIZE PARAMETER_B
+#define P_DIFFUSION PARAMETER_C
+#define P_AMOUNT PARAMETER_D
+
+using CloudSeed::ReverbController;
+
+/**
+ * CloudSeed stereo reverb. Button A cycles through factory presets, knobs
+ * override decay, line delay, diffusion feedback and dry/wet balance.
+ */
+class CloudSeedPatch : public Patch {
+public:
+    ReverbController* reverb;
+    int preset = 0;
+    static constexpr size_t num_controls = 4;
+    static constexpr Parameter controls[num_controls] = {
+        Parameter::LineDecay, Parameter::LineDelay,
+        Parameter::LateDiffusionFeedback, Parameter::MainOut};
+    float values[num_controls] = {-1, -1, -1, -1};
+
+    CloudSeedPatch() {
+        registerParameter(P_DECAY, "Decay");
+        setParameterValue(P_DECAY, 0.7);
+        registerParameter(P_SIZE, "Size");
+        setParameterValue(P_SIZE, 0.6);
+        registerParameter(P_DIFFUSION, "Diffusion");
+        setParameterValue(P_DIFFUSION, 0.65);
+        registerParameter(P_AMOUNT, "Mix");
+        setParameterValue(P_AMOUNT, 0.5);
+        reverb = ReverbController::create(getBlockSize(), getSampleRate());
+    }
+    ~CloudSeedPatch() {
+        ReverbController::destroy(reverb);
+    }
+    void buttonChanged(PatchButtonId bid, uint16_t value, uint16_t samples) override {
+        if (bid == BUTTON_A && value) {
+            preset = (preset + 1) % ReverbController::FactoryPresetCount;
+            reverb->loadFactoryPreset(ReverbController::FactoryPreset(preset));
+            // Reapply knob values on top of preset
+            for (size_t i = 0; i < num_controls; i++)
+                values[i] = -1;
+            debugMessage("Preset", preset);
+        }
+    }
+    void processAudio(AudioBuffer& buffer) {
+        float knobs[num_controls] = {
+            getParameterValue(P_DECAY), getParameterValue(P_SIZE),
+            getParameterValue(P_DIFFUSION), getParameterValue(P_AMOUNT)};
+        for (size_t i = 0; i < num_controls; i++) {
+            // Some parameters reseed delay lines, so they are only updated
+            // when value actually changes
+            if (fabsf(knobs[i] - values[i]) > 0.002) {
+                values[i] = knobs[i];
+                reverb->SetParameter(controls[i], knobs[i]);
+                if (controls[i] == Parameter::MainOut)
+                    reverb->SetParameter(Parameter::DryOut, 1 - knobs[i]);
+            }
+        }
+        reverb->process(buffer, buffer);
+    }
+};
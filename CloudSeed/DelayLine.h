@@ -1,23 +1,26 @@
 #ifndef DELAYLINE
 #define DELAYLINE
 
+#include "FloatArray.h"
 #include "AudioLib/Lp1.h"
+#include "AudioLib/Biquad.h"
 #include "ModulatedDelay.h"
 #include "AllpassDiffuser.h"
-#include "Biquad.h"
-#include "FloatArray.h"
-
-using namespace AudioLib;
 
 namespace CloudSeed {
+
+/**
+ * Late reverb line: modulated delay with feedback, optional allpass diffuser
+ * and post filters. Feedback is applied once per block, so loop delay is
+ * delay time plus one block.
+ */
 class DelayLine {
 private:
     ModulatedDelay* delay;
     AllpassDiffuser* diffuser;
-    Biquad* lowShelf;
-    Biquad* highShelf;
-    AudioLib::Lp1* lowPass;
-    FloatArray tempBuffer;
+    AudioLib::Biquad lowShelf;
+    AudioLib::Biquad highShelf;
+    AudioLib::Lp1 lowPass;
     FloatArray mixedBuffer;
     FloatArray filterOutputBuffer;
     float feedback;
@@ -30,47 +33,45 @@ public:
     bool CutoffEnabled;
     bool LateStageTap;
 
-    DelayLine() = default;
     DelayLine(int samplerate, ModulatedDelay* delay, AllpassDiffuser* diffuser,
-        AudioLib::Lp1* lowPass, Biquad* lowShelf, Biquad* highShelf,
-        FloatArray tempBuffer, FloatArray mixedBuffer, FloatArray filterOutputBuffer)
+        FloatArray mixedBuffer, FloatArray filterOutputBuffer)
         : delay(delay)
         , diffuser(diffuser)
-        , lowPass(lowPass)
-        , lowShelf(lowShelf)
-        , highShelf(highSHelf)
-        , tempBuffer(tempBuffer)
+        , lowShelf(AudioLib::Biquad::FilterType::LowShelf, samplerate)
+        , highShelf(AudioLib::Biquad::FilterType::HighShelf, samplerate)
+        , lowPass(samplerate)
         , mixedBuffer(mixedBuffer)
-        , filterOutputBuffer(filterOutputBuffer) {
-        lowShelf->setLowShelf(20.f, -20f);
-        highShelf->setHighshelf(19000, -20.f);
-        lowPass->SetCutoffHz(1000);
-        SetSamplerate(samplerate);
+        , filterOutputBuffer(filterOutputBuffer)
+        , feedback(0)
+        , samplerate(samplerate)
+        , DiffuserEnabled(false)
+        , LowShelfEnabled(false)
+        , HighShelfEnabled(false)
+        , CutoffEnabled(false)
+        , LateStageTap(false) {
+        lowShelf.Slope = 1.0;
+        lowShelf.SetGainDb(-20);
+        lowShelf.Frequency = 20;
+        lowShelf.Update();
+        highShelf.Slope = 1.0;
+        highShelf.SetGainDb(-20);
+        highShelf.Frequency = 19000;
+        highShelf.Update();
+        lowPass.SetCutoffHz(1000);
         SetDiffuserSeed(1, 0.0);
     }
 
-    ~DelayLine() {
-    }
-
     int GetSamplerate() {
         return samplerate;
     }
 
-    void SetSamplerate(int samplerate) {
-        this->samplerate = samplerate;
-        diffuser.SetSamplerate(samplerate);
-        lowPass.SetSamplerate(samplerate);
-        lowShelf.SetSamplerate(samplerate);
-        highShelf.SetSamplerate(samplerate);
-    }
-
     void SetDiffuserSeed(int seed, float crossSeed) {
-        diffuser.SetSeed(seed);
-        diffuser.SetCrossSeed(crossSeed);
+        diffuser->SetSeed(seed);
+        diffuser->SetCrossSeed(crossSeed);
     }
 
     void SetDelay(int delaySamples) {
-        delay.SampleDelay = delaySamples;
+        delay->SampleDelay = delaySamples;
     }
 
     void SetFeedback(float feedb) {
@@ -78,15 +79,15 @@ public:
     }
 
     void SetDiffuserDelay(int delaySamples) {
-        diffuser.SetDelay(delaySamples);
+        diffuser->SetDelay(delaySamples);
     }
 
     void SetDiffuserFeedback(float feedb) {
-        diffuser.SetFeedback(feedb);
+        diffuser->SetFeedback(feedb);
     }
 
     void SetDiffuserStages(int stages) {
-        diffuser.Stages = stages;
+        diffuser->Stages = stages;
     }
 
     void SetLowShelfGain(float gain) {
@@ -114,112 +115,92 @@ public:
     }
 
     void SetLineModAmount(float amount) {
-        delay.ModAmount = amount;
+        delay->ModAmount = amount;
     }
 
     void SetLineModRate(float rate) {
-        delay.ModRate = rate;
+        delay->ModRate = rate;
     }
 
     void SetDiffuserModAmount(float amount) {
-        diffuser.SetModulationEnabled(amount > 0.0);
-        diffuser.SetModAmount(amount);
+        diffuser->SetModulationEnabled(amount > 0.0);
+        diffuser->SetModAmount(amount);
     }
 
     void SetDiffuserModRate(float rate) {
-        diffuser.SetModRate(rate);
+        diffuser->SetModRate(rate);
     }
 
     void SetInterpolationEnabled(bool value) {
-        diffuser.SetInterpolationEnabled(value);
-    }
-
-    FloatArray GetOutput() {
-        if (LateStageTap) {
-            if (DiffuserEnabled)
-                return diffuser.GetOutput();
-            else
-                return mixedBuffer;
-        }
-        else {
-            return delay.GetOutput();
-        }
+        diffuser->SetInterpolationEnabled(value);
     }
 
+    /**
+     * Process a block. Output receives the line tap: diffused input of
+     * delay if LateStageTap is set, delay output otherwise. Input and output
+     * must not be the same array.
+     */
     void process(FloatArray input, FloatArray output) {
-        //for (int i = 0; i < sampleCount; i++)
-        //    mixedBuffer[i] = input[i] + filterOutputBuffer[i] * feedback;
 		mixedBuffer.copyFrom(filterOutputBuffer);
 		mixedBuffer.multiply(feedback);
 		mixedBuffer.add(input);
 
         if (LateStageTap) {
-            if (DiffuserEnabled) {
-                diffuser.Process(mixedBuffer, sampleCount);
-                delay.Process(diffuser.GetOutput(), sampleCount);
-            }
-            else {
-                delay.Process(mixedBuffer, sampleCount);
-            }
-
-            Utils::Copy(delay.GetOutput(), tempBuffer, sampleCount);
-        }
-        else {
-
-            if (DiffuserEnabled) {
-                delay.Process(mixedBuffer, sampleCount);
-                diffuser.Process(delay.GetOutput(), sampleCount);
-                Utils::Copy(diffuser.GetOutput(), tempBuffer, sampleCount);
+            if (DiffuserEnabled)
+                diffuser->process(mixedBuffer, mixedBuffer);
+            delay->process(mixedBuffer, filterOutputBuffer);
+            output.copyFrom(mixedBuffer);
             }
             else {
-                delay.Process(mixedBuffer, sampleCount);
-                Utils::Copy(delay.GetOutput(), tempBuffer, sampleCount);
+            delay->process(mixedBuffer, output);
+            if (DiffuserEnabled)
+                diffuser->process(output, filterOutputBuffer);
+            else
+                filterOutputBuffer.copyFrom(output);
             }
-        }
 
+        float* data = filterOutputBuffer.getData();
+        int len = filterOutputBuffer.getSize();
         if (LowShelfEnabled)
-            lowShelf->process(tempBuffer, tempBuffer);
+            lowShelf.Process(data, data, len);
         if (HighShelfEnabled)
-            highShelf->Process(tempBuffer, tempBuffer);
+            highShelf.Process(data, data, len);
         if (CutoffEnabled)
-            lowPass->Process(tempBuffer, tempBuffer);
-
-		filterOutputBuffer.copyFrom(tempBuffer);
+            lowPass.Process(data, data, len);
     }
 
     void ClearDiffuserBuffer() {
-        diffuser.ClearBuffers();
+        diffuser->ClearBuffers();
     }
 
     void ClearBuffers() {
-        delay.ClearBuffers();
-        diffuser.ClearBuffers();
+        delay->ClearBuffers();
+        diffuser->ClearBuffers();
         lowShelf.ClearBuffers();
         highShelf.ClearBuffers();
         lowPass.Output = 0;
-
-        for (int i = 0; i < bufferSize; i++) {
-            tempBuffer[i] = 0.0;
-            filterOutputBuffer[i] = 0.0;
-        }
+        mixedBuffer.clear();
+        filterOutputBuffer.clear();
     }
 
-    static DelayLine* create((int bufferSize, int samplerate) {
-        AudioLib::Lp1* lowPass = AudioLib::Lp1::create(samplerate);
+    static DelayLine* create(int blockSize, int samplerate) {
         // 2 second buffer, to prevent buffer overflow with modulation and
         // randomness added (Which may increase effective delay)
-        ModulatedDelay* delay =
-            ModulatedDelay::create(bufferSize, samplerate * 2, 10000);
-        AllpassDiffuser* diffuser = AllpassDiffuser::create(samplerate, 150); // 150ms buffer
-        Biquad* lowShelf = Biquad::create(samplerate);
-        Biquad* highShelf = Biquad::create(samplerate);
-        FloatArray tempBuffer = FloatArray::create(bufferSize);
-        FloatArray mixedBuffer = FloatArray::create(bufferSize);
-        FloatArray filterOutputBuffer = FloatArray::create(bufferSize);
-        return new DelayLine(samplerate, delay, difuser, lowPass, lowShelf,
-            highShelf, tempBufferm mixedBuffer, filterOutputBuffer)
-    }
+        ModulatedDelay* delay = ModulatedDelay::create(samplerate * 2, 10000);
+        // 150ms buffer, to allow for 100ms + modulation time
+        AllpassDiffuser* diffuser = AllpassDiffuser::create(samplerate, 150);
+        return new DelayLine(samplerate, delay, diffuser,
+            FloatArray::create(blockSize), FloatArray::create(blockSize));
+    }
+
+    static void destroy(DelayLine* line) {
+        ModulatedDelay::destroy(line->delay);
+        AllpassDiffuser::destroy(line->diffuser);
+        FloatArray::destroy(line->mixedBuffer);
+        FloatArray::destroy(line->filterOutputBuffer);
+        delete line;
 }
 };
 }
+
 #endif
@@ -1,24 +1,21 @@
 #ifndef MODULATEDALLPASS
 #define MODULATEDALLPASS
 
-#include "ModulatedAllpass.h"
-#include "FastSin.h"
-#include "Utils.h"
-extern void* custom_pool_allocate(size_t size);
-
-namespace CloudSeed
-{
-	class ModulatedAllpass
-	{
+#include <cmath>
+#include <cstdlib>
+#include "FloatArray.h"
+
+namespace CloudSeed {
+
+/**
+ * Schroeder allpass with optional modulation of delay time
+ */
+class ModulatedAllpass {
 	public:
-	// TODO: remove hardcode
-		const int DelayBufferSamples = 19200; // 100ms at 192Khz
 		static const int ModulationUpdateRate = 8;
 
 	private:
-		float* delayBuffer;
-		float* output;
-		int bufferSize;
+	FloatArray delayBuffer;
 		int index;
 		unsigned int samplesProcessed;
 
@@ -29,7 +26,6 @@ namespace CloudSeed
 		float gainB;
 
 	public:
-
 		int SampleDelay;
 		float Feedback;
 		float ModAmount;
@@ -38,126 +34,113 @@ namespace CloudSeed
 		bool InterpolationEnabled;
 		bool ModulationEnabled;
 
-		ModulatedAllpass(int bufferSize, int sampleDelay)
-		{
-			this->InterpolationEnabled = true;
-			this->bufferSize = bufferSize;
-			delayBuffer = new (custom_pool_allocate(sizeof(float) * DelayBufferSamples)) float[DelayBufferSamples];
-			output = new (custom_pool_allocate(sizeof(float) * bufferSize)) float[bufferSize];
-			SampleDelay = sampleDelay;
-			index = DelayBufferSamples - 1;
+	ModulatedAllpass(FloatArray delayBuffer, int sampleDelay)
+		: delayBuffer(delayBuffer)
+		, index(delayBuffer.getSize() - 1)
+		, SampleDelay(sampleDelay)
+		, Feedback(0)
+		, ModAmount(0)
+		, ModRate(0)
+		, InterpolationEnabled(true)
+		, ModulationEnabled(false) {
 			modPhase = 0.01 + 0.98 * std::rand() / (float)RAND_MAX;
-			ModRate = 0.0;
-			ModAmount = 0.0;
 			Update();
 		}
 
-		~ModulatedAllpass()
-		{
-			delete delayBuffer;
-			delete output;
+	void ClearBuffers() {
+		delayBuffer.clear();
 		}
 
-
-		inline float* GetOutput()
-		{
-			return output;
+	/**
+	 * Process a block, input and output may be the same array
+	 */
+	void process(FloatArray input, FloatArray output) {
+		if (ModulationEnabled)
+			ProcessWithMod(input, output);
+		else
+			ProcessNoMod(input, output);
 		}
 
-		void ClearBuffers()
-		{
-			Utils::ZeroBuffer(delayBuffer, DelayBufferSamples);
-			Utils::ZeroBuffer(output, bufferSize);
+	static ModulatedAllpass* create(int delayBufferSamples, int sampleDelay) {
+		return new ModulatedAllpass(FloatArray::create(delayBufferSamples), sampleDelay);
 		}
 
-		void Process(float* input, int sampleCount)
-		{
-			if (ModulationEnabled)
-				ProcessWithMod(input, sampleCount);
-			else
-				ProcessNoMod(input, sampleCount);
+	static void destroy(ModulatedAllpass* allpass) {
+		FloatArray::destroy(allpass->delayBuffer);
+		delete allpass;
 		}
 
+private:
+	void ProcessNoMod(FloatArray input, FloatArray output) {
+		const int delayBufferSamples = delayBuffer.getSize();
+		float* buffer = delayBuffer.getData();
+		int delayedIndex = index - SampleDelay;
+		if (delayedIndex < 0)
+			delayedIndex += delayBufferSamples;
 
-	private:
-		void ProcessNoMod(float* input, int sampleCount)
-		{
-			auto delayedIndex = index - SampleDelay;
-			if (delayedIndex < 0) delayedIndex += DelayBufferSamples;
+		size_t len = input.getSize();
+		for (size_t i = 0; i < len; i++) {
+			float bufOut = buffer[delayedIndex];
+			float inVal = input[i] + bufOut * Feedback;
 
-			for (int i = 0; i < sampleCount; i++)
-			{
-				auto bufOut = delayBuffer[delayedIndex];
-				auto inVal = input[i] + bufOut * Feedback;
-
-				delayBuffer[index] = inVal;
+			buffer[index] = inVal;
 				output[i] = bufOut - inVal * Feedback;
 
 				index++;
 				delayedIndex++;
-				if (index >= DelayBufferSamples) index -= DelayBufferSamples;
-				if (delayedIndex >= DelayBufferSamples) delayedIndex -= DelayBufferSamples;
-				samplesProcessed++;
-			}
+			if (index >= delayBufferSamples)
+				index -= delayBufferSamples;
+			if (delayedIndex >= delayBufferSamples)
+				delayedIndex -= delayBufferSamples;
 		}
+		samplesProcessed += len;
+	}
+
+	void ProcessWithMod(FloatArray input, FloatArray output) {
+		const int delayBufferSamples = delayBuffer.getSize();
+		float* buffer = delayBuffer.getData();
+		size_t len = input.getSize();
+		for (size_t i = 0; i < len; i++) {
+			if (samplesProcessed >= ModulationUpdateRate)
+				Update();
+
+			float bufOut;
+			if (InterpolationEnabled) {
+				int idxA = index - delayA;
+				int idxB = index - delayB;
+				idxA += delayBufferSamples * (idxA < 0); // modulo
+				idxB += delayBufferSamples * (idxB < 0); // modulo
+
+				bufOut = buffer[idxA] * gainA + buffer[idxB] * gainB;
+			}
+			else {
+				int idxA = index - delayA;
+				idxA += delayBufferSamples * (idxA < 0); // modulo
+				bufOut = buffer[idxA];
+			}
 
-		void ProcessWithMod(float* input, int sampleCount)
-		{
-			for (int i = 0; i < sampleCount; i++)
-			{
-				if (samplesProcessed >= ModulationUpdateRate)
-					Update();
-
-				float bufOut;
-
-				if (InterpolationEnabled)
-				{
-					int idxA = index - delayA;
-					int idxB = index - delayB;
-					idxA += DelayBufferSamples * (idxA < 0); // modulo
-					idxB += DelayBufferSamples * (idxB < 0); // modulo
-
-					bufOut = delayBuffer[idxA] * gainA + delayBuffer[idxB] * gainB;
-				}
-				else
-				{
-					int idxA = index - delayA;
-					idxA += DelayBufferSamples * (idxA < 0); // modulo
-					bufOut = delayBuffer[idxA];
-				}
-
-				auto inVal = input[i] + bufOut * Feedback;
-				delayBuffer[index] = inVal;
-				output[i] = bufOut - inVal * Feedback;
+			float inVal = input[i] + bufOut * Feedback;
+			buffer[index] = inVal;
+			output[i] = bufOut - inVal * Feedback;
 
-				index++;
-				if (index >= DelayBufferSamples) index -= DelayBufferSamples;
+			index++;
+			if (index >= delayBufferSamples)
+				index -= delayBufferSamples;
 				samplesProcessed++;
 			}
 		}
 
-		inline float Get(int delay)
-		{
-			int idx = index - delay;
-			if (idx < 0)
-				idx += DelayBufferSamples;
-
-			return delayBuffer[idx];
-		}
-
-		void Update()
-		{
+	void Update() {
 			modPhase += ModRate * ModulationUpdateRate;
 			if (modPhase > 1)
-				modPhase = std::fmod(modPhase, 1.0);
+			modPhase = std::fmod(modPhase, 1.0f);
 
-			auto mod = sin(modPhase);
+		float mod = sinf(modPhase * float(2 * M_PI));
 
 			if (ModAmount >= SampleDelay) // don't modulate to negative value
 				ModAmount = SampleDelay - 1;
 
-
-			auto totalDelay = SampleDelay + ModAmount * mod;
+		float totalDelay = SampleDelay + ModAmount * mod;
 			
 			if (totalDelay <= 0) // should no longer be required
 				totalDelay = 1;
@@ -165,14 +148,13 @@ namespace CloudSeed
 			delayA = (int)totalDelay;
 			delayB = (int)totalDelay + 1;
 
-			auto partial = totalDelay - delayA;
+		float partial = totalDelay - delayA;
 
 			gainA = 1 - partial;
 			gainB = partial;
 
 			samplesProcessed = 0;
 		}
-
 	};
 }
 
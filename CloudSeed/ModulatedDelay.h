@@ -1,28 +1,26 @@
 #ifndef MODULATEDDELAY
 #define MODULATEDDELAY
 
-#include "ModulatedDelay.h"
-#include "Utils.h"
-#include "FastSin.h"
+#include <cmath>
+#include <cstdlib>
+#include "FloatArray.h"
 
-extern void* custom_pool_allocate(size_t size);
+namespace CloudSeed {
 
-namespace CloudSeed
-{
-	class ModulatedDelay
-	{
-	private:
-
-		const int ModulationUpdateRate = 8;
+/**
+ * Delay with slow sine modulation of read position. Modulation is updated
+ * every ModulationUpdateRate samples and linearly interpolated in between.
+ */
+class ModulatedDelay {
+public:
+	static const int ModulationUpdateRate = 8;
 
-		float* delayBuffer;
-		float* output;
-		int bufferSize;
+	private:
+	FloatArray delayBuffer;
 		int writeIndex;
 		int readIndexA;
 		int readIndexB;
 		int samplesProcessed;
-		int delayBufferSizeSamples;
 
 		float modPhase;
 		float gainA;
@@ -30,88 +28,87 @@ namespace CloudSeed
 
 	public:
 		int SampleDelay;
-		
 		float ModAmount;
 		float ModRate;
 
-		ModulatedDelay(int bufferSize, int delayBufferSizeSamples, int sampleDelay)
-		{
-			this->delayBufferSizeSamples = delayBufferSizeSamples;
-			this->bufferSize = bufferSize;
-			this->delayBuffer = new (custom_pool_allocate(sizeof(float) * delayBufferSizeSamples)) float[delayBufferSizeSamples];
-			this->output = new (custom_pool_allocate(sizeof(float) * bufferSize)) float[bufferSize];
-			this->SampleDelay = sampleDelay;
-			writeIndex = 0;
+	ModulatedDelay(FloatArray delayBuffer, int sampleDelay)
+		: delayBuffer(delayBuffer)
+		, writeIndex(0)
+		, SampleDelay(sampleDelay)
+		, ModAmount(0)
+		, ModRate(0) {
 			modPhase = 0.01 + 0.98 * (std::rand() / (float)RAND_MAX);
-			ModRate = 0.0;
-			ModAmount = 0.0;
 			Update();
 		}
 
-		~ModulatedDelay()
-		{
-			delete delayBuffer;
-			delete output;
-		}
-
-		float* GetOutput()
-		{
-			return output;
-		}
-
-		void Process(float* input, int sampleCount)
-		{
-			for (int i = 0; i < sampleCount; i++)
-			{
+	void process(FloatArray input, FloatArray output) {
+		const int delayBufferSizeSamples = delayBuffer.getSize();
+		float* buffer = delayBuffer.getData();
+		size_t len = input.getSize();
+		for (size_t i = 0; i < len; i++) {
 				if (samplesProcessed == ModulationUpdateRate)
 					Update();
 
-				delayBuffer[writeIndex] = input[i];
-				output[i] = delayBuffer[readIndexA] * gainA + delayBuffer[readIndexB] * gainB;
+			buffer[writeIndex] = input[i];
+			output[i] = buffer[readIndexA] * gainA + buffer[readIndexB] * gainB;
 
 				writeIndex++;
 				readIndexA++;
 				readIndexB++;
-				if (writeIndex >= delayBufferSizeSamples) writeIndex -= delayBufferSizeSamples;
-				if (readIndexA >= delayBufferSizeSamples) readIndexA -= delayBufferSizeSamples;
-				if (readIndexB >= delayBufferSizeSamples) readIndexB -= delayBufferSizeSamples;
+			if (writeIndex >= delayBufferSizeSamples)
+				writeIndex -= delayBufferSizeSamples;
+			if (readIndexA >= delayBufferSizeSamples)
+				readIndexA -= delayBufferSizeSamples;
+			if (readIndexB >= delayBufferSizeSamples)
+				readIndexB -= delayBufferSizeSamples;
 				samplesProcessed++;
 			}
 		}
 
-		void ClearBuffers()
-		{
-			Utils::ZeroBuffer(delayBuffer, delayBufferSizeSamples);
-			Utils::ZeroBuffer(output, bufferSize);
+	void ClearBuffers() {
+		delayBuffer.clear();
 		}
 
+	/**
+	 * @param delayBufferSizeSamples maximum delay including modulation
+	 */
+	static ModulatedDelay* create(int delayBufferSizeSamples, int sampleDelay) {
+		return new ModulatedDelay(FloatArray::create(delayBufferSizeSamples), sampleDelay);
+	}
+
+	static void destroy(ModulatedDelay* delay) {
+		FloatArray::destroy(delay->delayBuffer);
+		delete delay;
+	}
 
 	private:
-		void Update()
-		{
+	void Update() {
 			modPhase += ModRate * ModulationUpdateRate;
 			if (modPhase > 1)
-				modPhase = std::fmod(modPhase, 1.0);
+			modPhase = std::fmod(modPhase, 1.0f);
 
-			auto mod = FastSin::Get(modPhase);
-			auto totalDelay = SampleDelay + ModAmount * mod;
+		float mod = sinf(modPhase * float(2 * M_PI));
+		float totalDelay = SampleDelay + ModAmount * mod;
 
-			auto delayA = (int)totalDelay;
-			auto delayB = (int)totalDelay + 1;
+		int delayA = (int)totalDelay;
+		int delayB = (int)totalDelay + 1;
 
-			auto partial = totalDelay - delayA;
+		float partial = totalDelay - delayA;
 
 			gainA = 1 - partial;
 			gainB = partial;
 
+		const int delayBufferSizeSamples = delayBuffer.getSize();
 			readIndexA = writeIndex - delayA;
 			readIndexB = writeIndex - delayB;
-			if (readIndexA < 0) readIndexA += delayBufferSizeSamples;
-			if (readIndexB < 0) readIndexB += delayBufferSizeSamples;
+		if (readIndexA < 0)
+			readIndexA += delayBufferSizeSamples;
+		if (readIndexB < 0)
+			readIndexB += delayBufferSizeSamples;
 
 			samplesProcessed = 0;
 		}
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,32 +1,28 @@
 #ifndef MULTITAPDIFFUSER
 #define MULTITAPDIFFUSER
 
-#include <vector>
-#include <memory>
-#include <array>
-#include "MultitapDiffuser.h"
-#include "Utils.h"
+#include <algorithm>
+#include <cmath>
+#include "FloatArray.h"
 #include "AudioLib/ShaRandom.h"
-extern void* custom_pool_allocate(size_t size);
 
-namespace CloudSeed
-{
-	using namespace std;
+namespace CloudSeed {
 
-	class MultitapDiffuser
-	{
+/**
+ * Early reflections generator, sums up to MaxTaps randomly spaced taps
+ */
+class MultitapDiffuser {
 	public:
 		static const int MaxTaps = 50;
+	static const int SeedCount = 100;
 
 	private:
-		float* buffer;
-		float* output;
-		int len;
-
-		int index;
-		vector<float> tapGains;
-		vector<int> tapPosition;
-		vector<float> seedValues;
+	FloatArray buffer;
+	int index;
+
+	float tapGains[MaxTaps];
+	int tapPosition[MaxTaps];
+	float seedValues[SeedCount];
 		int seed;
 		float crossSeed;
 		int count;
@@ -35,122 +31,117 @@ namespace CloudSeed
 		float decay;
 
 		bool isDirty;
-		vector<float> tapGainsTemp;
-		vector<int> tapPositionTemp;
+	float tapGainsTemp[MaxTaps];
+	int tapPositionTemp[MaxTaps];
 		int countTemp;
 
 	public:
-		MultitapDiffuser(int delayBufferSize)
-		{
-			len = delayBufferSize;
-			buffer = new (custom_pool_allocate(sizeof(float) * delayBufferSize)) float[delayBufferSize];
-			output = new (custom_pool_allocate(sizeof(float) * delayBufferSize)) float[delayBufferSize];
-			index = 0;
-			count = 1;
-			length = 1;
-			gain = 1.0;
-			decay = 0.0;
-			crossSeed = 0.0;
+	MultitapDiffuser(FloatArray buffer)
+		: buffer(buffer)
+		, index(0)
+		, seed(0)
+		, crossSeed(0)
+		, count(1)
+		, length(1)
+		, gain(1)
+		, decay(0)
+		, isDirty(false)
+		, countTemp(0) {
 			UpdateSeeds();
 		}
 
-		~MultitapDiffuser()
-		{
-			delete buffer;
-			delete output;
-		}
-
-
-		void SetSeed(int seed)
-		{
+	void SetSeed(int seed) {
 			this->seed = seed;
 			UpdateSeeds();
 		}
 
-		void SetCrossSeed(float crossSeed)
-		{
+	void SetCrossSeed(float crossSeed) {
 			this->crossSeed = crossSeed;
 			UpdateSeeds();
 		}
 
-		float* GetOutput()
-		{
-			return output;
-		}
-
-		void SetTapCount(int tapCount)
-		{
+	void SetTapCount(int tapCount) {
 			count = tapCount;
 			Update();
 		}
 
-		void SetTapLength(int tapLength)
-		{
+	void SetTapLength(int tapLength) {
 			length = tapLength;
 			Update();
 		}
 
-		void SetTapDecay(float tapDecay)
-		{
+	void SetTapDecay(float tapDecay) {
 			decay = tapDecay;
 			Update();
 		}
 
-		void SetTapGain(float tapGain)
-		{
+	void SetTapGain(float tapGain) {
 			gain = tapGain;
 			Update();
 		}
 
-		void Process(float* input, int sampleCount)
-		{
+	/**
+	 * Process a block, input and output must not be the same array
+	 */
+	void process(FloatArray input, FloatArray output) {
 			// prevents race condition when parameters are updated from Gui
-			if (isDirty)
-			{
-				tapGainsTemp = tapGains;
-				tapPositionTemp = tapPosition;
+		if (isDirty) {
+			std::copy(tapGains, tapGains + count, tapGainsTemp);
+			std::copy(tapPosition, tapPosition + count, tapPositionTemp);
 				countTemp = count;
 				isDirty = false;
 			}
 
-			int* const tapPos = &tapPositionTemp[0];
-			float* const tapGain = &tapGainsTemp[0];
+		const int* tapPos = tapPositionTemp;
+		const float* tapGain = tapGainsTemp;
 			const int cnt = countTemp;
-
-			for (int i = 0; i < sampleCount; i++)
-			{
-				if (index < 0) index += len;
-				buffer[index] = input[i];
-				output[i] = 0.0;
-
-				for (int j = 0; j < cnt; j++)
-				{
-					auto idx = (index + tapPos[j]) % len;
-					output[i] += buffer[idx] * tapGain[j];
+		const int len = buffer.getSize();
+		float* buf = buffer.getData();
+
+		size_t size = input.getSize();
+		for (size_t i = 0; i < size; i++) {
+			if (index < 0)
+				index += len;
+			buf[index] = input[i];
+			float out = 0;
+			for (int j = 0; j < cnt; j++) {
+				// Tap positions never exceed buffer length, so a single
+				// wrap is enough
+				int idx = index + tapPos[j];
+				if (idx >= len)
+					idx -= len;
+				out += buf[idx] * tapGain[j];
 				}
-
+			output[i] = out;
 				index--;
 			}
 		}
 
-		void ClearBuffers()
-		{
-			Utils::ZeroBuffer(buffer, len);
-			Utils::ZeroBuffer(output, len);
+	void ClearBuffers() {
+		buffer.clear();
 		}
 
+	/**
+	 * @param delayBufferSize must be longer than max tap length
+	 */
+	static MultitapDiffuser* create(int delayBufferSize) {
+		return new MultitapDiffuser(FloatArray::create(delayBufferSize));
+	}
 
-	private:
-		void Update()
-		{
-			vector<float> newTapGains;
-			vector<int> newTapPosition;
+	static void destroy(MultitapDiffuser* diffuser) {
+		FloatArray::destroy(diffuser->buffer);
+		delete diffuser;
+	}
 
+	private:
+	void Update() {
 			int s = 0;
 			auto rand = [&]() {return seedValues[s++]; };
 
 			if (count < 1)
 				count = 1;
+		if (count > MaxTaps)
+			count = MaxTaps;
 
 			if (length < count)
 				length = count;
@@ -158,49 +149,39 @@ namespace CloudSeed
 			// used to adjust the volume of the overall output as it grows when we add more taps
 			float tapCountFactor = 1.0 / (1 + std::sqrt(count / MaxTaps));
 
-			newTapGains.resize(count);
-			newTapPosition.resize(count);
-
-			vector<float> tapData(count, 0.0);
+		float tapData[MaxTaps];
 
-			auto sumLengths = 0.0;
-			for (size_t i = 0; i < count; i++)
-			{
-				auto val = 0.1 + rand();
+		float sumLengths = 0.0;
+		for (int i = 0; i < count; i++) {
+			float val = 0.1 + rand();
 				tapData[i] = val;
 				sumLengths += val;
 			}
 
-			auto scaleLength = length / sumLengths;
-			newTapPosition[0] = 0;
+		float scaleLength = length / sumLengths;
+		tapPosition[0] = 0;
 
-			for (int i = 1; i < count; i++)
-			{
-				newTapPosition[i] = newTapPosition[i - 1] + (int)(tapData[i] * scaleLength);
+		for (int i = 1; i < count; i++) {
+			tapPosition[i] = tapPosition[i - 1] + (int)(tapData[i] * scaleLength);
 			}
 
-			float sumGains = 0.0;
-			float lastTapPos = newTapPosition[count - 1];
-			for (int i = 0; i < count; i++)
-			{
+		float lastTapPos = tapPosition[count - 1];
+		for (int i = 0; i < count; i++) {
 				// when decay set to 0, there is no decay, when set to 1, the gain at the last sample is 0.01 = -40dB
-				auto g = std::pow(10, -decay * 2 * newTapPosition[i] / (float)(lastTapPos + 1));
+			float g = std::pow(10, -decay * 2 * tapPosition[i] / (float)(lastTapPos + 1));
 
-				auto tap = (2 * rand() - 1) * tapCountFactor;
-				newTapGains[i] = tap * g * gain;
+			float tap = (2 * rand() - 1) * tapCountFactor;
+			tapGains[i] = tap * g * gain;
 			}
 
 			// Set the tap vs. clean mix
-			newTapGains[0] = (1 - gain);
+		tapGains[0] = (1 - gain);
 
-			this->tapGains = newTapGains;
-			this->tapPosition = newTapPosition;
 			isDirty = true;
 		}
 
-		void UpdateSeeds()
-		{
-			this->seedValues = AudioLib::ShaRandom::Generate(seed, 100, crossSeed);
+	void UpdateSeeds() {
+		AudioLib::ShaRandom::Generate(seed, seedValues, SeedCount, crossSeed);
 			Update();
 		}
 	};
@@ -1,9 +1,9 @@
-
 #ifndef REVERBCHANNEL
 #define REVERBCHANNEL
 
-#include <map>
-#include <memory>
+#include <algorithm>
+#include <cmath>
+#include "FloatArray.h"
 #include "Parameter.h"
 #include "ModulatedDelay.h"
 #include "MultitapDiffuser.h"
@@ -12,43 +12,37 @@
 #include "AudioLib/Hp1.h"
 #include "DelayLine.h"
 #include "AllpassDiffuser.h"
-
-#include <cmath>
-#include "ReverbChannel.h"
-#include "AudioLib/ShaRandom.h"
 #include "Utils.h"
 
-extern void* custom_pool_allocate(size_t size);
-
-using namespace std;
+namespace CloudSeed {
 
-namespace CloudSeed
-{
-	enum class ChannelLR
-	{
+enum class ChannelLR {
 		Left,
 		Right
 	};
 
-	class ReverbChannel
-	{
+/**
+ * Single reverb channel: input filters, predelay, early reflections,
+ * early diffusion and TotalLineCount late lines.
+ */
+class ReverbChannel {
 	private:
 		static const int TotalLineCount = 2;
 
-		map<Parameter, float> parameters;
+	float parameters[(int)Parameter::Count];
 		int samplerate;
-		int bufferSize;
 
-		ModulatedDelay preDelay;
-		MultitapDiffuser multitap;
-		AllpassDiffuser diffuser;
-		vector<DelayLine*> lines;
-		AudioLib::ShaRandom rand;
+	ModulatedDelay* preDelay;
+	MultitapDiffuser* multitap;
+	AllpassDiffuser* diffuser;
+	DelayLine* lines[TotalLineCount];
 		AudioLib::Hp1 highPass;
 		AudioLib::Lp1 lowPass;
-		float* tempBuffer;
-		float* lineOutBuffer;
-		float* outBuffer;
+	FloatArray tempBuffer;
+	FloatArray predelayBuffer;
+	FloatArray earlyBuffer;
+	FloatArray lineBuffer;
+	FloatArray lineOutBuffer;
 		int delayLineSeed;
 		int postDiffusionSeed;
 
@@ -66,94 +60,57 @@ namespace CloudSeed
 		ChannelLR channelLr;
 
 	public:
-		
-		ReverbChannel(int bufferSize, int samplerate, ChannelLR leftOrRight)
-			: preDelay(bufferSize, (int)(samplerate * 1.0), 100) // 1 second delay buffer
-			, multitap(samplerate) // use samplerate = 1 second delay buffer
+	ReverbChannel(int samplerate, ChannelLR leftOrRight, ModulatedDelay* preDelay,
+		MultitapDiffuser* multitap, AllpassDiffuser* diffuser, DelayLine** lines,
+		FloatArray tempBuffer, FloatArray predelayBuffer, FloatArray earlyBuffer,
+		FloatArray lineBuffer, FloatArray lineOutBuffer)
+		: samplerate(samplerate)
+		, preDelay(preDelay)
+		, multitap(multitap)
+		, diffuser(diffuser)
 			, highPass(samplerate)
 			, lowPass(samplerate)
-			, diffuser(samplerate, 150) // 150ms buffer, to allow for 100ms + modulation time
-		{
-			this->channelLr = leftOrRight;
-
-			for (int i = 0; i < TotalLineCount; i++)
-				lines.push_back(new (custom_pool_allocate(sizeof(DelayLine)))DelayLine(bufferSize, samplerate));
-
-			this->bufferSize = bufferSize;
-
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-				this->parameters[static_cast<Parameter>(value)] = 0.0;
-
-			crossSeed = 0.0;
-			lineCount = TotalLineCount;
-			diffuser.SetInterpolationEnabled(true);
+		, tempBuffer(tempBuffer)
+		, predelayBuffer(predelayBuffer)
+		, earlyBuffer(earlyBuffer)
+		, lineBuffer(lineBuffer)
+		, lineOutBuffer(lineOutBuffer)
+		, delayLineSeed(0)
+		, postDiffusionSeed(0)
+		, lineCount(TotalLineCount)
+		, highPassEnabled(false)
+		, lowPassEnabled(false)
+		, diffuserEnabled(false)
+		, dryOut(0)
+		, predelayOut(0)
+		, earlyOut(0)
+		, lineOut(0)
+		, crossSeed(0)
+		, channelLr(leftOrRight) {
+		std::copy(lines, lines + TotalLineCount, this->lines);
+		std::fill(parameters, parameters + (int)Parameter::Count, 0.0f);
+		diffuser->SetInterpolationEnabled(true);
 			highPass.SetCutoffHz(20);
 			lowPass.SetCutoffHz(20000);
-
-			tempBuffer = new  (custom_pool_allocate(sizeof(float)*bufferSize))float[bufferSize];
-			lineOutBuffer = new (custom_pool_allocate(sizeof(float) * bufferSize))float[bufferSize];
-			outBuffer = new (custom_pool_allocate(sizeof(float) * bufferSize))float[bufferSize];
-
-			this->samplerate = samplerate;
-		}
-
-		~ReverbChannel()
-		{
-			for (auto line : lines)
-				delete line;
-
-			delete tempBuffer;
-			delete lineOutBuffer;
-			delete outBuffer;
 		}
 
-		int GetSamplerate()
-		{
+	int GetSamplerate() {
 			return samplerate;
 		}
 
-		void SetSamplerate(int samplerate)
-		{
-			this->samplerate = samplerate;
-			highPass.SetSamplerate(samplerate);
-			lowPass.SetSamplerate(samplerate);
-
-			for (int i = 0; i < lines.size(); i++)
-			{
-				lines[i]->SetSamplerate(samplerate);
-			}
-
-			auto update = [&](Parameter p) { SetParameter(p, parameters[p]); };
-			update(Parameter::PreDelay);
-			update(Parameter::TapLength);
-			update(Parameter::DiffusionDelay);
-			update(Parameter::LineDelay);
-			update(Parameter::LateDiffusionDelay);
-			update(Parameter::EarlyDiffusionModRate);
-			update(Parameter::LineModRate);
-			update(Parameter::LateDiffusionModRate);
-			update(Parameter::LineModAmount);
-			UpdateLines();
-		}
-
-		float* GetOutput()
-		{
-			return outBuffer;
-		}
-
-		float* GetLineOutput()
-		{
+	/**
+	 * Output of late lines from last processed block, before output gain
+	 */
+	FloatArray GetLineOutput() {
 			return lineOutBuffer;
 		}
 
-		void SetParameter(Parameter para, float value)
-		{
-			parameters[para] = value;
+	void SetParameter(Parameter para, float value) {
+		parameters[(int)para] = value;
 
-			switch (para)
-			{
+		switch (para) {
 			case Parameter::PreDelay:
-				preDelay.SampleDelay = (int)Ms2Samples(value);
+			preDelay->SampleDelay = (int)Ms2Samples(value);
 				break;
 			case Parameter::HighPass:
 				highPass.SetCutoffHz(value);
@@ -163,34 +120,33 @@ namespace CloudSeed
 				break;
 
 			case Parameter::TapCount:
-				multitap.SetTapCount((int)value);
+			multitap->SetTapCount((int)value);
 				break;
 			case Parameter::TapLength:
-				multitap.SetTapLength((int)Ms2Samples(value));
+			multitap->SetTapLength((int)Ms2Samples(value));
 				break;
 			case Parameter::TapGain:
-				multitap.SetTapGain(value);
+			multitap->SetTapGain(value);
 				break;
 			case Parameter::TapDecay:
-				multitap.SetTapDecay(value);
+			multitap->SetTapDecay(value);
 				break;
 
-			case Parameter::DiffusionEnabled:
-			{
-				auto newVal = value >= 0.5;
+		case Parameter::DiffusionEnabled: {
+			bool newVal = value >= 0.5;
 				if (newVal != diffuserEnabled)
-					diffuser.ClearBuffers();
+				diffuser->ClearBuffers();
 				diffuserEnabled = newVal;
 				break;
 			}
 			case Parameter::DiffusionStages:
-				diffuser.Stages = (int)value;
+			diffuser->Stages = (int)value;
 				break;
 			case Parameter::DiffusionDelay:
-				diffuser.SetDelay((int)Ms2Samples(value));
+			diffuser->SetDelay((int)Ms2Samples(value));
 				break;
 			case Parameter::DiffusionFeedback:
-				diffuser.SetFeedback(value);
+			diffuser->SetFeedback(value);
 				break;
 
 			case Parameter::LineCount:
@@ -204,9 +160,8 @@ namespace CloudSeed
 				break;
 
 			case Parameter::LateDiffusionEnabled:
-				for (auto line : lines)
-				{
-					auto newVal = value >= 0.5;
+			for (auto line : lines) {
+				bool newVal = value >= 0.5;
 					if (newVal != line->DiffuserEnabled)
 						line->ClearDiffuserBuffer();
 					line->DiffuserEnabled = newVal;
@@ -247,11 +202,11 @@ namespace CloudSeed
 				break;
 
 			case Parameter::EarlyDiffusionModAmount:
-				diffuser.SetModulationEnabled(value > 0.0);
-				diffuser.SetModAmount(Ms2Samples(value));
+			diffuser->SetModulationEnabled(value > 0.0);
+			diffuser->SetModAmount(Ms2Samples(value));
 				break;
 			case Parameter::EarlyDiffusionModRate:
-				diffuser.SetModRate(value);
+			diffuser->SetModRate(value);
 				break;
 			case Parameter::LineModAmount:
 				UpdateLines();
@@ -267,10 +222,10 @@ namespace CloudSeed
 				break;
 
 			case Parameter::TapSeed:
-				multitap.SetSeed((int)value);
+			multitap->SetSeed((int)value);
 				break;
 			case Parameter::DiffusionSeed:
-				diffuser.SetSeed((int)value);
+			diffuser->SetSeed((int)value);
 				break;
 			case Parameter::DelaySeed:
 				delayLineSeed = (int)value;
@@ -282,10 +237,9 @@ namespace CloudSeed
 				break;
 
 			case Parameter::CrossSeed:
-
 				crossSeed = channelLr == ChannelLR::Right ? value : 0;
-				multitap.SetCrossSeed(value);
-				diffuser.SetCrossSeed(value);
+			multitap->SetCrossSeed(value);
+			diffuser->SetCrossSeed(value);
 				UpdateLines();
 				UpdatePostDiffusion();
 				break;
@@ -330,137 +284,141 @@ namespace CloudSeed
 				for (auto line : lines)
 					line->SetInterpolationEnabled(value >= 0.5);
 				break;
+
+		default:
+			break;
 			}
 		}
 
-		void Process(float* input, int sampleCount)
-		{
-			int len = sampleCount;
-			auto predelayOutput = preDelay.GetOutput();
-			auto lowPassInput = highPassEnabled ? tempBuffer : input;
+	/**
+	 * Process a block, input and output may be the same array.
+	 * Block size must match the one used in create().
+	 */
+	void process(FloatArray input, FloatArray output) {
+		int len = input.getSize();
+		float* temp = tempBuffer.getData();
 
 			if (highPassEnabled)
-				highPass.Process(input, tempBuffer, len);
+			highPass.Process(input.getData(), temp, len);
 			if (lowPassEnabled)
-				lowPass.Process(lowPassInput, tempBuffer, len);
+			lowPass.Process(highPassEnabled ? temp : input.getData(), temp, len);
 			if (!lowPassEnabled && !highPassEnabled)
-				Utils::Copy(input, tempBuffer, len);
+			tempBuffer.copyFrom(input);
 
 			// completely zero if no input present
 			// Previously, the very small values were causing some really strange CPU spikes
-			for (int i = 0; i < len; i++)
-			{
-				auto n = tempBuffer[i];
+		for (int i = 0; i < len; i++) {
+			float n = temp[i];
 				if (n * n < 0.000000001)
-					tempBuffer[i] = 0;
+				temp[i] = 0;
 			}
 
-			preDelay.Process(tempBuffer, len);
-			multitap.Process(preDelay.GetOutput(), len);
+		preDelay->process(tempBuffer, predelayBuffer);
+		multitap->process(predelayBuffer, earlyBuffer);
+		if (diffuserEnabled)
+			diffuser->process(earlyBuffer, earlyBuffer);
 
-			auto earlyOutStage = diffuserEnabled ? diffuser.GetOutput() : multitap.GetOutput();
-
-			if (diffuserEnabled)
-			{
-				diffuser.Process(multitap.GetOutput(), len);
-				Utils::Copy(diffuser.GetOutput(), tempBuffer, len);
+		for (int i = 0; i < lineCount; i++) {
+			if (i == 0) {
+				lines[i]->process(earlyBuffer, lineOutBuffer);
 			}
-			else
-			{
-				Utils::Copy(multitap.GetOutput(), tempBuffer, len);
+			else {
+				lines[i]->process(earlyBuffer, lineBuffer);
+				lineOutBuffer.add(lineBuffer);
 			}
-
-			// mix in the feedback from the other channel
-			//for (int i = 0; i < len; i++)
-			//	tempBuffer[i] += crossMix[i];
-
-			for (int i = 0; i < lineCount; i++)
-				lines[i]->Process(tempBuffer, len);
-
-			for (int i = 0; i < lineCount; i++)
-			{
-				auto buf = lines[i]->GetOutput();
-
-				if (i == 0)
-				{
-					for (int j = 0; j < len; j++)
-						tempBuffer[j] = buf[j];
-				}
-				else
-				{
-					for (int j = 0; j < len; j++)
-						tempBuffer[j] += buf[j];
+		}
+		lineOutBuffer.multiply(GetPerLineGain());
+
+		for (int i = 0; i < len; i++) {
+			output[i] =
+				dryOut * input[i] +
+				predelayOut * predelayBuffer[i] +
+				earlyOut * earlyBuffer[i] +
+				lineOut * lineOutBuffer[i];
 				}
 			}
 
-			auto perLineGain = GetPerLineGain();
-			Utils::Gain(tempBuffer, perLineGain, len);
-			Utils::Copy(tempBuffer, lineOutBuffer, len);
-
-			for (int i = 0; i < len; i++)
-			{
-				outBuffer[i] =
-					dryOut           * input[i] +
-					predelayOut      * predelayOutput[i] +
-					earlyOut         * earlyOutStage[i] +
-					lineOut          * tempBuffer[i];
-			}
-		}
-
-		void ClearBuffers()
-		{
-			for (int i = 0; i < bufferSize; i++)
-			{
-				tempBuffer[i] = 0.0;
-				lineOutBuffer[i] = 0.0;
-				outBuffer[i] = 0.0;
-			}
+	void ClearBuffers() {
+		tempBuffer.clear();
+		predelayBuffer.clear();
+		earlyBuffer.clear();
+		lineBuffer.clear();
+		lineOutBuffer.clear();
 
 			lowPass.Output = 0;
 			highPass.Output = 0;
 
-			preDelay.ClearBuffers();
-			multitap.ClearBuffers();
-			diffuser.ClearBuffers();
+		preDelay->ClearBuffers();
+		multitap->ClearBuffers();
+		diffuser->ClearBuffers();
 			for (auto line : lines)
 				line->ClearBuffers();
 		}
 
+	static ReverbChannel* create(int blockSize, int samplerate, ChannelLR leftOrRight) {
+		// 1 second delay buffer
+		ModulatedDelay* preDelay = ModulatedDelay::create(samplerate, 100);
+		// use samplerate = 1 second delay buffer
+		MultitapDiffuser* multitap = MultitapDiffuser::create(samplerate);
+		// 150ms buffer, to allow for 100ms + modulation time
+		AllpassDiffuser* diffuser = AllpassDiffuser::create(samplerate, 150);
+		DelayLine* lines[TotalLineCount];
+		for (int i = 0; i < TotalLineCount; i++)
+			lines[i] = DelayLine::create(blockSize, samplerate);
+		return new ReverbChannel(samplerate, leftOrRight, preDelay, multitap, diffuser, lines,
+			FloatArray::create(blockSize), FloatArray::create(blockSize),
+			FloatArray::create(blockSize), FloatArray::create(blockSize),
+			FloatArray::create(blockSize));
+	}
+
+	static void destroy(ReverbChannel* channel) {
+		ModulatedDelay::destroy(channel->preDelay);
+		MultitapDiffuser::destroy(channel->multitap);
+		AllpassDiffuser::destroy(channel->diffuser);
+		for (auto line : channel->lines)
+			DelayLine::destroy(line);
+		FloatArray::destroy(channel->tempBuffer);
+		FloatArray::destroy(channel->predelayBuffer);
+		FloatArray::destroy(channel->earlyBuffer);
+		FloatArray::destroy(channel->lineBuffer);
+		FloatArray::destroy(channel->lineOutBuffer);
+		delete channel;
+	}
 
 	private:
-		float GetPerLineGain()
-		{
+	float GetPerLineGain() {
 			return 1.0 / std::sqrt(lineCount);
 		}
 
-		void UpdateLines()
-		{
-			auto lineDelaySamples = (int)Ms2Samples(parameters[Parameter::LineDelay]);
-			auto lineDecayMillis = parameters[Parameter::LineDecay] * 1000;
-			auto lineDecaySamples = Ms2Samples(lineDecayMillis);
+	void UpdateLines() {
+		int lineDelaySamples = (int)Ms2Samples(parameters[(int)Parameter::LineDelay]);
+		float lineDecayMillis = parameters[(int)Parameter::LineDecay] * 1000;
+		float lineDecaySamples = Ms2Samples(lineDecayMillis);
 
-			auto lineModAmount = Ms2Samples(parameters[Parameter::LineModAmount]);
-			auto lineModRate = parameters[Parameter::LineModRate];
+		float lineModAmount = Ms2Samples(parameters[(int)Parameter::LineModAmount]);
+		float lineModRate = parameters[(int)Parameter::LineModRate];
 
-			auto lateDiffusionModAmount = Ms2Samples(parameters[Parameter::LateDiffusionModAmount]);
-			auto lateDiffusionModRate = parameters[Parameter::LateDiffusionModRate];
+		float lateDiffusionModAmount = Ms2Samples(parameters[(int)Parameter::LateDiffusionModAmount]);
+		float lateDiffusionModRate = parameters[(int)Parameter::LateDiffusionModRate];
 
-			auto delayLineSeeds = ShaRandom::Generate(delayLineSeed, (int)lines.size() * 3, crossSeed);
-			int count = (int)lines.size();
+		const int count = TotalLineCount;
+		float delayLineSeeds[count * 3];
+		AudioLib::ShaRandom::Generate(delayLineSeed, delayLineSeeds, count * 3, crossSeed);
 
-			for (int i = 0; i < count; i++)
-			{
-				auto modAmount = lineModAmount * (0.7 + 0.3 * delayLineSeeds[i + count]);
-				auto modRate = lineModRate * (0.7 + 0.3 * delayLineSeeds[i + 2 * count]) / samplerate;
+		for (int i = 0; i < count; i++) {
+			float modAmount = lineModAmount * (0.7 + 0.3 * delayLineSeeds[i + count]);
+			float modRate = lineModRate * (0.7 + 0.3 * delayLineSeeds[i + 2 * count]) / samplerate;
 				
-				auto delaySamples = (0.5 + 1.0 * delayLineSeeds[i]) * lineDelaySamples;
-				if (delaySamples < modAmount + 2) // when the delay is set really short, and the modulation is very high
-					delaySamples = modAmount + 2; // the mod could actually take the delay time negative, prevent that! -- provide 2 extra sample as margin of safety
-
-				auto dbAfter1Iteration = delaySamples / lineDecaySamples * (-60); // lineDecay is the time it takes to reach T60
-				auto gainAfter1Iteration = Utils::DB2gain(dbAfter1Iteration);
-
+			float delaySamples = (0.5 + 1.0 * delayLineSeeds[i]) * lineDelaySamples;
+			// when the delay is set really short, and the modulation is very high
+			// the mod could actually take the delay time negative, prevent that!
+			// -- provide 2 extra sample as margin of safety
+			if (delaySamples < modAmount + 2)
+				delaySamples = modAmount + 2;
 
+			// lineDecay is the time it takes to reach T60
+			float dbAfter1Iteration = delaySamples / lineDecaySamples * (-60);
+			float gainAfter1Iteration = Utils::DB2gain(dbAfter1Iteration);
 
 				lines[i]->SetDelay((int)delaySamples);
 				lines[i]->SetFeedback(gainAfter1Iteration);
@@ -471,19 +429,15 @@ namespace CloudSeed
 			}
 		}
 
-		void UpdatePostDiffusion()
-		{
-			for (int i = 0; i < lines.size(); i++)
+	void UpdatePostDiffusion() {
+		for (int i = 0; i < TotalLineCount; i++)
 				lines[i]->SetDiffuserSeed(((long long)postDiffusionSeed) * (i + 1), crossSeed);
 		}
 
-		float Ms2Samples(float value)
-		{
+	float Ms2Samples(float value) {
 			return value / 1000.0 * samplerate;
 		}
-
 	};
-
 }
 
 #endif
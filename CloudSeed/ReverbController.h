@@ -4,53 +4,96 @@
 #ifndef REVERBCONTROLLER
 #define REVERBCONTROLLER
 
-#include <vector>
-#include "Default.h"
+#include <cmath>
+#include "FloatArray.h"
+#include "SignalProcessor.h"
 #include "Parameter.h"
 #include "ReverbChannel.h"
-
-#include "ReverbController.h"
 #include "AudioLib/ValueTables.h"
 #include "AllpassDiffuser.h"
 #include "MultitapDiffuser.h"
 #include "Utils.h"
 
-namespace CloudSeed
-{
-	class ReverbController
-	{
+namespace CloudSeed {
+
+/**
+ * Stereo CloudSeed reverb. Parameters are normalized to 0..1 and stored in
+ * a flat array indexed by Parameter, scaled values are passed to channels.
+ *
+ * All buffers are allocated in create(), processing works on blocks of
+ * the size given there.
+ */
+class ReverbController : public MultiSignalProcessor {
 	private:
-		static const int bufferSize = 48; // just make it huge by default...
+	using ValueTables = AudioLib::ValueTables;
+
 		int samplerate;
 
-		ReverbChannel channelL;
-		ReverbChannel channelR;
-		float leftChannelIn[bufferSize];
-		float rightChannelIn[bufferSize];
-		float leftLineBuffer[bufferSize];
-		float rightLineBuffer[bufferSize];
+	ReverbChannel* channelL;
+	ReverbChannel* channelR;
+	FloatArray leftChannelIn;
+	FloatArray rightChannelIn;
 		float parameters[(int)Parameter::Count];
 
 	public:
-		ReverbController(int samplerate)
-			: channelL(bufferSize, samplerate, ChannelLR::Left)
-			, channelR(bufferSize, samplerate, ChannelLR::Right)
-		{
-			this->samplerate = samplerate;
+	enum FactoryPreset {
+		Chorus,
+		DullEchos,
+		Hyperplane,
+		MediumSpace,
+		NoiseInTheHallway,
+		RubiKaFields,
+		SmallRoom,
+		NinetiesAreBack,
+		ThroughTheLookingGlass,
+		FactoryPresetCount
+	};
+
+	ReverbController(int samplerate, ReverbChannel* channelL, ReverbChannel* channelR,
+		FloatArray leftChannelIn, FloatArray rightChannelIn)
+		: samplerate(samplerate)
+		, channelL(channelL)
+		, channelR(channelR)
+		, leftChannelIn(leftChannelIn)
+		, rightChannelIn(rightChannelIn) {
 			initFactoryChorus();
-			//initFactoryDullEchos();
-			//initFactoryHyperplane();
-			//initFactoryMediumSpace();
-			//initFactoryNoiseInTheHallway();
-			//initFactoryRubiKaFields();
-			//initFactorySmallRoom();
-			//initFactory90sAreBack();
-			//initFactoryThroughTheLookingGlass();
-			
 		}
 
-		void initFactoryChorus()
-		{
+	void loadFactoryPreset(FactoryPreset preset) {
+		switch (preset) {
+		case Chorus:
+			initFactoryChorus();
+			break;
+		case DullEchos:
+			initFactoryDullEchos();
+			break;
+		case Hyperplane:
+			initFactoryHyperplane();
+			break;
+		case MediumSpace:
+			initFactoryMediumSpace();
+			break;
+		case NoiseInTheHallway:
+			initFactoryNoiseInTheHallway();
+			break;
+		case RubiKaFields:
+			initFactoryRubiKaFields();
+			break;
+		case SmallRoom:
+			initFactorySmallRoom();
+			break;
+		case NinetiesAreBack:
+			initFactory90sAreBack();
+			break;
+		case ThroughTheLookingGlass:
+			initFactoryThroughTheLookingGlass();
+			break;
+		default:
+			break;
+		}
+	}
+
+	void initFactoryChorus() {
 			//parameters from Chorus Delay in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0.0;
@@ -100,16 +143,11 @@ namespace CloudSeed
 			parameters[(int)Parameter::LateStageTap] = 1.0;
 			parameters[(int)Parameter::Interpolation] = 0.0;
 
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-
-		void initFactoryDullEchos()
-		{
+	void initFactoryDullEchos() {
 			//parameters from Dull Echos in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0.0;
@@ -159,16 +197,11 @@ namespace CloudSeed
 			parameters[(int)Parameter::LateStageTap] = 0.0;
 			parameters[(int)Parameter::Interpolation] = 1.0;
 
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-	
-		void initFactoryHyperplane()
-		{
+	void initFactoryHyperplane() {
 			//parameters from Hyperplane in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0.1549999862909317;
@@ -218,15 +251,11 @@ namespace CloudSeed
 			parameters[(int)Parameter::LateStageTap] = 1.0;
 			parameters[(int)Parameter::Interpolation] = 0.0;
 
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-		void initFactoryMediumSpace()
-		{
+	void initFactoryMediumSpace() {
 			//parameters from Medium Space in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0.0;
@@ -276,15 +305,11 @@ namespace CloudSeed
 			parameters[(int)Parameter::LateStageTap] = 1.0;
 			parameters[(int)Parameter::Interpolation] = 1.0;
 
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-		void initFactoryNoiseInTheHallway()
-		{
+	void initFactoryNoiseInTheHallway() {
 			//parameters from Noise In The Hallway in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0.0;
@@ -334,15 +359,11 @@ namespace CloudSeed
 			parameters[(int)Parameter::LateStageTap] = 0.0;
 			parameters[(int)Parameter::Interpolation] = 1.0;
 
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-		void initFactoryRubiKaFields()
-		{
+	void initFactoryRubiKaFields() {
 			//parameters from Rubi-Ka Fields in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0.32499998807907104;
@@ -392,16 +413,11 @@ namespace CloudSeed
 			parameters[(int)Parameter::LateStageTap] = 1.0;
 			parameters[(int)Parameter::Interpolation] = 0.0;
 
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-		
-		void initFactorySmallRoom()
-		{
+	void initFactorySmallRoom() {
 			//parameters from Small Room in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0.0;
@@ -450,15 +466,11 @@ namespace CloudSeed
 			parameters[(int)Parameter::CutoffEnabled] = 0.0;
 			parameters[(int)Parameter::LateStageTap] = 1.0;
 			parameters[(int)Parameter::Interpolation] = 1.0;
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-		void initFactory90sAreBack()
-		{
+	void initFactory90sAreBack() {
 			//parameters from The 90s Are Back in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0;
@@ -507,15 +519,11 @@ namespace CloudSeed
 			parameters[(int)Parameter::CutoffEnabled] = 0;
 			parameters[(int)Parameter::LateStageTap] = 1;
 			parameters[(int)Parameter::Interpolation] = 1;
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-		void initFactoryThroughTheLookingGlass()
-		{
+	void initFactoryThroughTheLookingGlass() {
 			//parameters from Through The Looking Glass in
 			//https://github.com/ValdemarOrn/CloudSeed/tree/master/Factory%20Programs
 			parameters[(int)Parameter::InputMix] = 0.0;
@@ -564,40 +572,31 @@ namespace CloudSeed
 			parameters[(int)Parameter::CutoffEnabled] = 1.0;
 			parameters[(int)Parameter::LateStageTap] = 1.0;
 			parameters[(int)Parameter::Interpolation] = 1.0;
-			for (auto value = 0; value < (int)Parameter::Count; value++)
-			{
+		for (int value = 0; value < (int)Parameter::Count; value++)
 				SetParameter((Parameter)value, parameters[value]);
 			}
 
-		}
-
-		int GetSamplerate()
-		{
+	int GetSamplerate() {
 			return samplerate;
 		}
 
-		void SetSamplerate(int samplerate)
-		{
-			this->samplerate = samplerate;
-
-			channelL.SetSamplerate(samplerate);
-			channelR.SetSamplerate(samplerate);
-		}
-
-		int GetParameterCount()
-		{
+	int GetParameterCount() {
 			return (int)Parameter::Count;
 		}
 
-		float* GetAllParameters()
-		{
+	float* GetAllParameters() {
 			return parameters;
 		}
 
-		float GetScaledParameter(Parameter param)
-		{
-			switch (param)
-			{
+	/**
+	 * Get normalized parameter value
+	 */
+	float GetParameter(Parameter param) {
+		return P(param);
+	}
+
+	float GetScaledParameter(Parameter param) {
+		switch (param) {
 				// Input
 			case Parameter::InputMix:                  return P(Parameter::InputMix);
 			case Parameter::PreDelay:                  return (int)(P(Parameter::PreDelay) * 1000);
@@ -672,53 +671,59 @@ namespace CloudSeed
 			return 0.0;
 		}
 
-		void SetParameter(Parameter param, float value)
-		{
+	/**
+	 * Set normalized parameter value
+	 */
+	void SetParameter(Parameter param, float value) {
 			parameters[(int)param] = value;
-			auto scaled = GetScaledParameter(param);
+		float scaled = GetScaledParameter(param);
 			
-			channelL.SetParameter(param, scaled);
-			channelR.SetParameter(param, scaled);
+		channelL->SetParameter(param, scaled);
+		channelR->SetParameter(param, scaled);
 		}
 
-		
-
-		void ClearBuffers()
-		{
-			channelL.ClearBuffers();
-			channelR.ClearBuffers();
+	void ClearBuffers() {
+		channelL->ClearBuffers();
+		channelR->ClearBuffers();
 		}
 
-		void Process(float* input, float* output, int bufferSize)
-		{
-			auto len = bufferSize;
-			auto cm = GetScaledParameter(Parameter::InputMix) * 0.5;
-			auto cmi = (1 - cm);
+	void process(AudioBuffer& input, AudioBuffer& output) {
+		FloatArray left_in = input.getSamples(0);
+		FloatArray right_in = input.getSamples(1);
+		float cm = GetScaledParameter(Parameter::InputMix) * 0.5;
+		float cmi = (1 - cm);
 
-			for (int i = 0; i < len; i++)
-			{
-				leftChannelIn[i] = input[i*2] * cmi + input[i*2+1] * cm;
-				rightChannelIn[i] = input[i*2+1] * cmi + input[i*2] * cm;
+		size_t len = left_in.getSize();
+		for (size_t i = 0; i < len; i++) {
+			leftChannelIn[i] = left_in[i] * cmi + right_in[i] * cm;
+			rightChannelIn[i] = right_in[i] * cmi + left_in[i] * cm;
 			}
 
-			channelL.Process(leftChannelIn, len);
-			channelR.Process(rightChannelIn, len);
-			auto leftOut = channelL.GetOutput();
-			auto rightOut = channelR.GetOutput();
+		channelL->process(leftChannelIn, output.getSamples(0));
+		channelR->process(rightChannelIn, output.getSamples(1));
+	}
 
-			for (int i = 0; i < len; i++)
-			{
-				output[i*2] = leftOut[i];
-				output[i*2+1] = rightOut[i];
+	static ReverbController* create(int blockSize, int samplerate) {
+		return new ReverbController(samplerate,
+			ReverbChannel::create(blockSize, samplerate, ChannelLR::Left),
+			ReverbChannel::create(blockSize, samplerate, ChannelLR::Right),
+			FloatArray::create(blockSize), FloatArray::create(blockSize));
 			}
+
+	static void destroy(ReverbController* reverb) {
+		ReverbChannel::destroy(reverb->channelL);
+		ReverbChannel::destroy(reverb->channelR);
+		FloatArray::destroy(reverb->leftChannelIn);
+		FloatArray::destroy(reverb->rightChannelIn);
+		delete reverb;
 		}
 		
 	private:
-		float P(Parameter para)
-		{
-			auto idx = (int)para;
+	float P(Parameter para) {
+		int idx = (int)para;
 			return idx >= 0 && idx < (int)Parameter::Count ? parameters[idx] : 0.0;
 		}
 	};
 }
+
 #endif
@@ -2,7 +2,9 @@
 #define __WAV_PARSER_HPP__
 
 #include <cstring>
+#include "FloatArray.h"
 #include "Resource.h"
+#include "message.h"
 
 /**
  * Recommended reading:
@@ -10,46 +12,52 @@
  * https://web.archive.org/web/20141226210234/http://www.sonicspot.com/guide/wavefiles.html#list
  */
 
-#define min(a, b) (a < b ? a : b)
+static constexpr size_t sample_name_len = 12;
 
-static constexpr size_t sample_name_len  = 12;
-static constexpr size_t max_samples      = 32;
-static constexpr uint32_t headerRiffType = 0x57415645; // "WAVE"
-static constexpr uint32_t adtlTypeId     = 0x6164746C; // "adtl"
+/**
+ * Chunk IDs are compared as little endian words read from file
+ */
+static constexpr uint32_t fourcc(const char* id) {
+    return uint32_t(id[0]) | (uint32_t(id[1]) << 8) | (uint32_t(id[2]) << 16) |
+        (uint32_t(id[3]) << 24);
+}
+
+static constexpr uint32_t headerRiffType = fourcc("WAVE");
+static constexpr uint32_t adtlTypeId = fourcc("adtl");
 
 enum chunk_id : uint32_t {
-    CI_HEADER  = 0x52494646, // "RIFF"
-    CI_FORMAT  = 0x666D7420, // "fmt "
-    CI_DATA    = 0x64617461, // "data"
-    CI_CUE     = 0x63756520, // "cue "
-    CI_LIST    = 0x4c495354, // "LIST" - Note that "list" (0x6C696E74) is also used, seems to be less common
-    CI_LABEL   = 0x6C61626C, // "labl"
+    CI_HEADER = fourcc("RIFF"),
+    CI_FORMAT = fourcc("fmt "),
+    CI_DATA = fourcc("data"),
+    CI_CUE = fourcc("cue "),
+    CI_LIST = fourcc("LIST"), // Note that "list" is also used, seems to be less common
+    CI_LABEL = fourcc("labl"),
 };
 
 enum sample_format : uint16_t {
-    SF_UNKNOWN      = 0,
-    SF_UINT8        = 8,
-    SF_INT16        = 16,
-    SF_INT24        = 24,
-    SF_INT32        = 32,
+    SF_UNKNOWN = 0,
+    SF_UINT8 = 8,
+    SF_INT16 = 16,
+    SF_INT24 = 24,
+    SF_INT32 = 32,
 };
 
 /**
  * This is a common header for all chunk objects
  */
 struct ChunkHeader {
-	chunk_id chunkId;
-	uint32_t dataSize;
+    chunk_id chunkId;
+    uint32_t dataSize;
 };
 
 /**
  * Wave header is the top level chunk
  */
 struct WaveHeader {
-	char riffType[4];
+    uint32_t riffType;
 
     bool isValid() const {
-        return (uint32_t)riffType == headerRiffType;
+        return riffType == headerRiffType;
     }
 };
 
@@ -58,44 +66,50 @@ struct WaveHeader {
  */
 struct FormatChunk {
     enum comp_code : uint16_t {
-        CC_UNKNOWN      = 0x0000,
-        CC_PCM          = 0x0001,
-        CC_MS_ADPCM     = 0x0002,
-        CC_IEEE_FLOAT   = 0x0003,
-        CC_ALAW         = 0x0006,
-        CC_ULAW         = 0x0007,
-        CC_IMA_ADPCM    = 0x0011,
-        CC_ITU_G723     = 0x0016,
-        CC_GSM          = 0x0031,
-        CC_ITU_G721     = 0x0040,
-        CC_MPEG         = 0x0050,
+        CC_UNKNOWN = 0x0000,
+        CC_PCM = 0x0001,
+        CC_MS_ADPCM = 0x0002,
+        CC_IEEE_FLOAT = 0x0003,
+        CC_ALAW = 0x0006,
+        CC_ULAW = 0x0007,
+        CC_IMA_ADPCM = 0x0011,
+        CC_ITU_G723 = 0x0016,
+        CC_GSM = 0x0031,
+        CC_ITU_G721 = 0x0040,
+        CC_MPEG = 0x0050,
         CC_EXPERIMENTAL = 0xFFFF,
     };
 
-	comp_code compressionCode;
-	uint16_t numberOfChannels;
-	uint32_t sampleRate;
-	uint32_t averageBytesPerSecond;
-	uint16_t blockAlign;
-	sample_format significantBitsPerSample;
+    comp_code compressionCode;
+    uint16_t numberOfChannels;
+    uint32_t sampleRate;
+    uint32_t averageBytesPerSecond;
+    uint16_t blockAlign;
+    sample_format significantBitsPerSample;
+
+    bool isFloat() const {
+        return compressionCode == CC_IEEE_FLOAT;
+    }
 };
+static_assert(sizeof(FormatChunk) == 16, "Unexpected format chunk size");
 
 /**
  * Cue chunk contains the list of cue points
  */
 struct CueChunk {
-	uint32_t cuePointsCount;
-//	CuePoint *cuePoints;
+    uint32_t cuePointsCount;
+    // Followed by cuePointsCount cue points
 };
 
 struct CuePoint {
-	uint32_t cuePointId;
-	uint32_t playOrderPosition;
-	chunk_id dataChunkId;
-	uint32_t chunkStart;
-	uint32_t blockStart;
-	uint32_t frameOffset;
+    uint32_t cuePointId;
+    uint32_t playOrderPosition;
+    chunk_id dataChunkId;
+    uint32_t chunkStart;
+    uint32_t blockStart;
+    uint32_t frameOffset;
 };
+static_assert(sizeof(CuePoint) == 24, "Unexpected cue point size");
 
 struct AssociatedList {
     uint32_t typeId;
@@ -107,359 +121,397 @@ struct Label {
     // Followed by variable number of bytes as label text
 };
 
-class Sample {
-public:
-    Sample(Resource& resource, uint32_t sample_id)
-        : resource(resource)
-        , sample_id(sample_id) {}
-
-    uin32_t getId() const {
-        return sample_id;
-    }
-
-    void setName(const char* new_name) {
-        strcpy(name, new_name, sample_name_len - 1);
-    }
-    
-    void setOffset(uint32_t offset){
-        start_offset = offset;
-    }
-
-    void setFormat(sample_format new_format){
-        sample_format = format;
-    }
-
-    void setFloatSamples(){
-        isFloat = true;
-        sample_format = SF_INT32;
-    }
-    
-    void setChannels(uint32_t num_channels){
-        channels = num_channels;
-    }
-
-    template<typename Data>
-    const Data* getData() {}
-
-    template<typename Data>
-    void loadData(Data** dst) {
-
-    }
-private:
-    Resource& resource;
-    uint32_t sample_id;
-	uint32_t start_offset; // in bytes
-	uint32_t size; // in bytes
-    bool isFloat;
-    uint32_t channels;
-    sample_format format;
+/**
+ * Named part of data chunk that starts at a cue point and lasts until the
+ * next one
+ */
+struct WavRegion {
+    uint32_t cue_id;
+    uint32_t offset; // in bytes from start of resource
+    uint32_t length; // in frames
+    const FormatChunk* format;
     char name[sample_name_len];
-
-    bool isValidSample() {
-        if (isFloat)
-            return format == SF_INT32;
-        else
-            return format == SF_UINT8 || format == SF_INT16 || format == SF_INT24 || format == SF_INT32;
-    }
-    uint32_t getSampleBytes() const {
-        return format / 8;
-    }
-    uint32_t getFramesCount() const {
-        return samples / channels / getSampleBytes();
-    }
-
-};
-
-class WavFile {
-public:
-    WavFile(uint8_t num_samples)
-        : num_samples(num_samples) {
-            samples = new Sample[num_samples];
-        }
-
-    ~WavFile(){
-        for (uint32_t i = 0; i < samples_num; i++){
-            delete samples[i];
-        }
-    }
-
-    Sample* addSample(const char* name, size_t length, size_t channels, void* src) {
-        if (last_sample < num_samples) {
-            Sample* sample = Sample::create(length, channels);
-            sample->setName(name);
-            sample->loadData(src);
-            samples[samples_num++] = sample;
-            return sample;
-        }
-        else {
-            return NULL;
-        }
-    }
-
-    Sample* getSample(uint32_t sample_id) const {
-        for (uint32_t i = 0; i < samples_num; i++){
-            if (samples[i]->getId() == sample_id)
-                return samples[i];
-        }
-    }
-private:
-    size_t samples_num;
-    size_t last_sample = 0;
-    Sample* samples;
-};
-
-class CuePointEntry {
-public:
-    const char* name;
-    size_t offset;
 };
 
 /**
  * Chunk pointer
- * 
+ *
  * @param offset - offset for data belonging to this chunk
  * @param size - data size
  */
 class ChunkPointer {
 public:
-    ChunkPointer();
+    ChunkPointer() = default;
     ChunkPointer(const ChunkHeader& header, uint32_t offset)
         : offset(offset)
-        , size(header.dataSize) {}
-    void loadData(void* dst, Resource& resource) {
-        resource.read(dst, size, offset);
+        , size(header.dataSize) {
     }
-    bool isFound(){
+    bool isFound() const {
         return size > 0;
     }
+    uint32_t getOffset() const {
+        return offset;
+    }
+    uint32_t getSize() const {
+        return size;
+    }
+
 private:
     uint32_t offset = 0;
     uint32_t size = 0;
 };
 
-template<bool use_cues, size_t max_cues = 256>
+/**
+ * Parser for WAV resources that contain a number of sounds marked by cue
+ * points, i.e. as written by KastleDrum.py.
+ *
+ * Chunks are read from resource one header at a time, so only the memory
+ * mapped data or the parts that are requested are ever in RAM. The result
+ * is a fixed size index of regions that can be accessed by index or by
+ * label name in constant time. Without use_cues, or if file has no cue
+ * points, the whole data chunk is a single region.
+ */
+template <bool use_cues, size_t max_cues = 64>
 class WavParser {
 public:
-    Sample* data = NULL;
-    Sample* cues[] = NULL;
-
-    WavParser(const char* resource_name) {
-        resource = Resource::open(resource_name);
-        if (use_cues)
-            cues = new Sample[max_cues];
+    WavParser(Resource* resource)
+        : resource(resource) {
+    }
+    virtual ~WavParser() {
+        Resource::destroy(resource);
     }
-    ~WavParser(){
-        if (resource != NULL)
-            Resource::destroy(resource);
-        if (wav_file != NULL)
-            delete wav_file;
+    const FormatChunk& getFormat() const {
+        return format;
+    }
+    size_t getNumberOfRegions() const {
+        return num_regions;
+    }
+    const WavRegion* getRegion(size_t index) const {
+        return index < num_regions ? &regions[index] : NULL;
     }
     /**
-     * Override this to add extra chunks support
+     * @return region index or -1 if no region has this label
      */
-    virtual handleUnknownChunk(ChunkHeader chunk){
-        skip(chunk.dataSize);
-    }
-    const FormatChunk* loadFormatChunk(){
-        if (!format_chunk.isFound())
-            return NULL;
-        // Read format chunk.
-        const FormatChunk* fchunk = new FormatChunk();
-        format_chunk.loadData(fchunk, resource);
-        // Check int/float format. Compressed formats are not supported.
-        if (format_chunk->compressionCode == CC_PCM) {
-            is_float = false;
-        }
-        else if (format_chunk.compressionCode == CC_IEEE_FLOAT){
-            is_float = true;
-        }
-        else {
-            debugMessage("Unsupported format");
-            delete fchunk;
-            return NULL;
+    int findRegion(const char* name) const {
+        size_t slot = hash(name) % table_size;
+        while (name_table[slot] != 0) {
+            const WavRegion& region = regions[name_table[slot] - 1];
+            if (strncmp(region.name, name, sample_name_len - 1) == 0)
+                return name_table[slot] - 1;
+            slot = (slot + 1) % table_size;
         }
-        return format_chunk;
+        return -1;
     }
-    /*
-     * Loads whole data into a single sample
+    /**
+     * @return region data if resource is memory mapped, NULL otherwise
      */
-    const Sample* loadData(){
+    const uint8_t* getData(const WavRegion& region) {
+        if (!resource->isMemoryMapped())
+            return NULL;
+        return resource->getData() + region.offset;
     }
-    /*
-     * Load sample from a cue point by index
+    /**
+     * Read raw frames of region, starting from frame start
+     * @return number of frames read
      */
-    const Sample* loadSample(uint8_t cue_id){
-
+    size_t read(const WavRegion& region, void* dst, size_t frames, size_t start = 0) {
+        if (start >= region.length)
+            return 0;
+        frames = minSize(frames, region.length - start);
+        size_t block = format.blockAlign;
+        return resource->read(dst, frames * block, region.offset + start * block) / block;
     }
-    /*
-     * Load sample from a cue point by name
+    /**
+     * Convert a channel of region to float, reading through a small stack
+     * buffer
+     * @return number of samples written to dst
      */
-    const Sample* loadSample(const char* name){        
-    }
-    bool parseHeader(){
-        if (resource == NULL){
-            debugMessage("Resource not found");
-            return false;
+    size_t readFloat(const WavRegion& region, FloatArray dst, size_t start = 0,
+        size_t channel = 0) {
+        if (channel >= format.numberOfChannels)
+            return 0;
+        uint8_t buffer[read_buffer_size];
+        size_t block = format.blockAlign;
+        size_t bytes = format.significantBitsPerSample / 8;
+        size_t chunk_frames = sizeof(buffer) / block;
+        size_t done = 0;
+        while (done < dst.getSize()) {
+            size_t frames = dst.getSize() - done;
+            frames = read(region, buffer, minSize(frames, chunk_frames), start + done);
+            if (frames == 0)
+                break;
+            const uint8_t* src = buffer + channel * bytes;
+            for (size_t i = 0; i < frames; i++) {
+                dst[done++] = toFloat(src);
+                src += block;
+            }
         }
-        
-        offset = 0;
-        loadChunk(header_chunk);
-
-        if (header_chunk.chunkId == CI_HEADER && header_chunk.dataSize == sizeof(WaveHeader)
-            header = (const WaveHeader*)getChunk()
-        if (header == NULL || !header->isValid()) {
+        return done;
+    }
+    bool parseChunks() {
+        ChunkHeader chunk_header;
+        WaveHeader header;
+        if (!loadChunk(chunk_header) || chunk_header.chunkId != CI_HEADER ||
+            !loadChunk(header) || !header.isValid()) {
             debugMessage("Invalid header");
             return false;
         }
-        return true;
-    }
-    bool parseCuePoints(){
-
-    }
-    bool parseData(){
-        
-    }
-    bool parseChunks(){        
-        bool header_parsed = parseHeader();
-        if (!header_parsed)
-            return false;
-
-        ChunkHeader chunk_header;
-        do {
-            loadHeader(chunk_header);
-            switch(chunk_header.chunkId) {
-            case CI_FORMAT: {
-                format_chunk = ChunkPointer(chunk_header, offset);
-                skip(chunk_header.dataSize);
+        size_t end = minSize(resource->getSize(), chunk_header.dataSize + sizeof(ChunkHeader));
+        while (offset + sizeof(ChunkHeader) <= end && loadChunk(chunk_header)) {
+            ChunkPointer chunk(chunk_header, offset);
+            switch (chunk_header.chunkId) {
+            case CI_FORMAT:
+                format_chunk = chunk;
                 break;
-            }
-            case CI_CUE: 
-                if (use_cues) {
-                    cue_list_chunk = ChunkPointer(chunk_header, offset);
-                    CueChunk cue_chunk;
-                    loadChunk(cue_chunk);
-                    cue_list_size = min(max_samples, cue_chunk.cuePointsCount);                    
-                    skip(cue_chunk.cuePointsCount * sizeof(CuePoint));
-                }
+            case CI_DATA:
+                data_chunk = chunk;
+                break;
+            case CI_CUE:
+                if (use_cues)
+                    cue_list_chunk = chunk;
                 break;
             case CI_LIST:
                 if (use_cues) {
                     AssociatedList adtl;
-                    loadChunk(adtl);
-                    if (adtl.AssociatedListTypeId == adtlTypeId) {
-                        // Only set chunk pointer if expected type is found
-                        label_list_chunk = ChunkPointer(chunk_header, offset);
-                    }
-                    skip(chunk_header.dataSize - sizeof(AssociatedList);
-                }
-                else {
-                    skip(cue_chunk.dataSize);
-                }
-                break;
-            case CI_LABEL:
-                if (use_cues) {
-                    /*
-                    auto* label = getChunk<Label>();
-                    auto sample = wav_file.getSample(label->cuePointId);                
-                    uint32_t num_bytes = min(sample_name_len, chunk.dataSize);
-                    uint8_t buffer[num_bytes];
-                    resource->read(reinterpret_cast<void*>(buffer), num_bytes, offset);
-                    if (sample != NULL) {
-                        sample->setName(reinterpret_cast<const char*>(buffer));
-                    }
-                    offset += chunk.dataSize - sizeof(Label.cuePointId);
-                    */
-                }
-                else {
-                    skip(cue_chunk.dataSize);
+                    // Only set chunk pointer if expected type is found
+                    if (chunk.getSize() >= sizeof(adtl) &&
+                        resource->read(&adtl, sizeof(adtl), offset) == sizeof(adtl) &&
+                        adtl.typeId == adtlTypeId)
+                        label_list_chunk = chunk;
                 }
                 break;
-            case CI_DATA:
-                data_chunk = ChunkPointer(chunk_header, offset);
-                skip(cue_chunk.dataSize);
-                break;
             default:
-                // Unsupported chunk ID - just ignore it
                 handleUnknownChunk(chunk_header);
                 break;
             }
-
-        } while (offset < header->dataSize + sizeof(ChunkHeader));
+            // Chunk past end of resource is either truncated data or a
+            // corrupt size that would wrap offset on 32 bit targets
+            if (chunk_header.dataSize > end - offset)
+                break;
+            skip(chunk_header.dataSize + (chunk_header.dataSize & 1));
+        }
+        if (!data_chunk.isFound() || !parseFormat())
+            return false;
+        // Truncated data chunk is used up to the end of resource
+        size_t available = resource->getSize() > data_chunk.getOffset() ?
+            resource->getSize() - data_chunk.getOffset() : 0;
+        data_frames = minSize(data_chunk.getSize(), available) / format.blockAlign;
+        if (use_cues)
+            parseCuePoints();
+        if (num_regions == 0)
+            addRegion(0, 0);
+        setLengths();
+        if (use_cues)
+            parseLabels();
+        return true;
     }
     static WavParser* create(const char* resource_name) {
-        WavParser* parser = new WavParser(resource_name);
-        if (parser->resource->hasData())
-            header = new WaveHeader();
+        Resource* resource = Resource::open(resource_name);
+        if (resource == NULL) {
+            debugMessage("Resource not found");
+            return NULL;
+        }
+        WavParser* parser = new WavParser(resource);
+        if (!parser->parseChunks()) {
+            delete parser;
+            return NULL;
+        }
+        return parser;
     }
-    static void destroy(WavParser* parser){
-        /*
-         * Destroy loaded data.
-         */
-        if (parser->sample != NULL)
-            delete sample;
-        if (parser->cue_samples != NULL)
-            delete[] cue_samples;
+    static void destroy(WavParser* parser) {
+        delete parser;
     }
 
 protected:
+    static constexpr size_t table_size = max_cues * 2;
+    static constexpr size_t read_buffer_size = 256;
+    Resource* resource;
+    FormatChunk format = {};
+    ChunkPointer format_chunk;
+    ChunkPointer data_chunk;
+    ChunkPointer cue_list_chunk;
+    ChunkPointer label_list_chunk;
+    size_t offset = 0;
+    size_t data_frames = 0;
+    size_t num_regions = 0;
+    WavRegion regions[max_cues];
+    uint8_t name_table[table_size] = {}; // region index + 1, 0 for empty slot
+    static_assert(max_cues < 256, "Name table stores 8 bit indexes");
+
     /**
-     * Load chunk to preallocated buffer without changing offset
+     * Override this to add extra chunks support
      */
-    template<typename Chunk>
-    void loadChunk(Chunk& chunk){
-        offset += resource->read(reinterpet_cast<void*>(&chunk), sizeof(Chunk), offset);
+    virtual void handleUnknownChunk(const ChunkHeader&) {
     }
+
     /**
-     * Allocate object on the stack, read it from resource and increment offset
+     * Read chunk to preallocated buffer and advance offset
      */
-    template<typename Chunk>
-    void* getChunk(){
-        Chunk* chunk = new Chunk();
-        offset += resource->read((void*)chunk, sizeof(Chunk), offset);
-        return chunk;
+    template <typename Chunk>
+    bool loadChunk(Chunk& chunk) {
+        size_t len = resource->read(&chunk, sizeof(Chunk), offset);
+        offset += len;
+        return len == sizeof(Chunk);
     }
+
     /**
      * Rewind offset forward
      */
-    void skip(size_t size){
+    void skip(size_t size) {
         offset += size;
     }
+
+    bool parseFormat() {
+        if (!format_chunk.isFound() || format_chunk.getSize() < sizeof(FormatChunk)) {
+            debugMessage("Missing format");
+            return false;
+        }
+        resource->read(&format, sizeof(format), format_chunk.getOffset());
+        // Check int/float format. Compressed formats are not supported.
+        bool valid;
+        switch (format.significantBitsPerSample) {
+        case SF_UINT8:
+        case SF_INT16:
+        case SF_INT24:
+            valid = format.compressionCode == FormatChunk::CC_PCM;
+            break;
+        case SF_INT32:
+            valid = format.compressionCode == FormatChunk::CC_PCM || format.isFloat();
+            break;
+        default:
+            valid = false;
+            break;
+        }
+        if (!valid || format.numberOfChannels == 0 ||
+            format.blockAlign < format.numberOfChannels * format.significantBitsPerSample / 8 ||
+            format.blockAlign > read_buffer_size) {
+            debugMessage("Unsupported format");
+            return false;
+        }
+        return true;
+    }
+
+    void addRegion(uint32_t cue_id, uint32_t frame) {
+        WavRegion& region = regions[num_regions++];
+        region.cue_id = cue_id;
+        region.offset = frame; // converted to bytes by setLengths()
+        region.length = 0;
+        region.format = &format;
+        region.name[0] = '\0';
+    }
+
     /**
-     * Parse cue points
+     * Cue points are kept sorted by position
      */
-    uin8_t parseCuePoints(){
-        for (int i = 0; i < cue_list_size; i++){
-            
+    void parseCuePoints() {
+        if (cue_list_chunk.getSize() < sizeof(CueChunk))
+            return;
+        offset = cue_list_chunk.getOffset();
+        CueChunk cue_chunk;
+        if (!loadChunk(cue_chunk))
+            return;
+        size_t count = minSize(cue_chunk.cuePointsCount,
+            (cue_list_chunk.getSize() - sizeof(CueChunk)) / sizeof(CuePoint));
+        for (size_t i = 0; i < count && num_regions < max_cues; i++) {
+            CuePoint cue_point;
+            if (!loadChunk(cue_point))
+                break;
+            // Some writers leave data chunk ID empty
+            if ((cue_point.dataChunkId != CI_DATA && cue_point.dataChunkId != 0) ||
+                cue_point.frameOffset >= data_frames)
+                continue;
+            size_t pos = num_regions;
+            addRegion(cue_point.cuePointId, cue_point.frameOffset);
+            WavRegion region = regions[pos];
+            while (pos > 0 && regions[pos - 1].offset > region.offset) {
+                regions[pos] = regions[pos - 1];
+                pos--;
+            }
+            regions[pos] = region;
+        }
+    }
+
+    void setLengths() {
+        for (size_t i = 0; i < num_regions; i++) {
+            uint32_t next = i + 1 < num_regions ? regions[i + 1].offset : data_frames;
+            regions[i].length = next - regions[i].offset;
+            regions[i].offset = data_chunk.getOffset() + regions[i].offset * format.blockAlign;
         }
+    }
 
-                        auto* cue_chunk = getChunk<CueChunk>();
-                    for (uint32_t i = 0; i < cue_chunk->cuePointsCount; i++) {
-                        CuePoint cue_point;
-                        loadChunk<CuePoint>(cue_point);
-                        if (cue_point.dataChunkId != CI_DATA) {
-                            continue;
-                        }
-                        else {
-                            auto sample = wav_file->addSample(cue_point.cuePointId, resource);
-                            if (sample != NULL){
-                                sample->setOffset(cuePoint.frameOffset);
-                            }
-                        }
+    void parseLabels() {
+        if (!label_list_chunk.isFound())
+            return;
+        offset = label_list_chunk.getOffset() + sizeof(AssociatedList);
+        size_t end = label_list_chunk.getOffset() + label_list_chunk.getSize();
+        ChunkHeader chunk_header;
+        while (offset + sizeof(ChunkHeader) <= end && loadChunk(chunk_header)) {
+            if (chunk_header.dataSize > end - offset)
+                break;
+            size_t next = offset + chunk_header.dataSize + (chunk_header.dataSize & 1);
+            Label label;
+            if (chunk_header.chunkId == CI_LABEL && chunk_header.dataSize > sizeof(Label) &&
+                loadChunk(label)) {
+                for (size_t i = 0; i < num_regions; i++) {
+                    if (regions[i].cue_id == label.cuePointId) {
+                        setName(i, chunk_header.dataSize - sizeof(Label));
+                        break;
                     }
-private:
-    Resource* resource = NULL;
-    WavFile* wav_file = NULL;
-    WaveHeader* header;
-    CueList* cue_points;
-    ChunkPointer header_chunk;
-    ChunkPointer format_chunk;
-    ChunkPointer cue_list_chunk;
-    ChunkPointer label_list_chunk;
-    size_t offset ;
-    uint32_t sample_rate;
-    uint32_t num_channels;
-    uin8_t cue_list_size = 0;
-    bool is_float;
+                }
+            }
+            offset = next;
+        }
+    }
+
+    void setName(size_t index, size_t len) {
+        char* name = regions[index].name;
+        len = resource->read(name, minSize(len, sample_name_len - 1), offset);
+        name[len] = '\0';
+        if (name[0] == '\0')
+            return;
+        size_t slot = hash(name) % table_size;
+        while (name_table[slot] != 0) {
+            // First region with the same name is found by lookup
+            if (strcmp(regions[name_table[slot] - 1].name, name) == 0)
+                return;
+            slot = (slot + 1) % table_size;
+        }
+        name_table[slot] = index + 1;
+    }
+
+    static size_t minSize(size_t a, size_t b) {
+        return a < b ? a : b;
+    }
+
+    /**
+     * FNV-1a hash of name, limited to stored length
+     */
+    static uint32_t hash(const char* name) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < sample_name_len - 1 && name[i] != '\0'; i++)
+            h = (h ^ uint8_t(name[i])) * 16777619u;
+        return h;
+    }
+
+    float toFloat(const uint8_t* src) const {
+        switch (format.significantBitsPerSample) {
+        case SF_UINT8:
+            return (src[0] - 128) * (1.f / 128);
+        case SF_INT16:
+            return int16_t(src[0] | (src[1] << 8)) * (1.f / 32768);
+        case SF_INT24:
+            return int32_t((src[0] << 8) | (src[1] << 16) | (src[2] << 24)) * (1.f / 2147483648.f);
+        default: {
+            uint32_t word = src[0] | (src[1] << 8) | (src[2] << 16) | (uint32_t(src[3]) << 24);
+            if (format.isFloat()) {
+                float value;
+                memcpy(&value, &word, sizeof(value));
+                return value;
+            }
+            return int32_t(word) * (1.f / 2147483648.f);
+        }
+        }
+    }
 };
 
 typedef WavParser<false> SimpleWavParser;
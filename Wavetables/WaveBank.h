@@ -2,24 +2,163 @@
 #define __WaveBank_h
 
 #include "Oscillator.h"
+#include "Resource.h"
 
-template<size_t X, size_t Y, size_t Z, size_t SIZE>
+/**
+ * Header of a precomputed bank resource, made by makewavebank.py.
+ * Waves follow the header as Sample[X][Y][Z][stride], where stride is SIZE
+ * or SIZE+1 for builds with DDS_INTERPOLATE. Scaled formats put a
+ * float[X][Y][Z] array of table scales before the waves.
+ */
+struct WaveBankHeader {
+  static constexpr uint32_t MAGIC = 0x4b4e4257; // "WBNK"
+  static constexpr uint16_t VERSION = 1;
+  enum Format : uint16_t {
+    FORMAT_FLOAT32 = 0,
+    FORMAT_INT16 = 1,
+    FORMAT_FLOAT16 = 2
+  };
+  uint32_t magic;
+  uint16_t version;
+  uint16_t format;
+  uint16_t x;
+  uint16_t y;
+  uint16_t z;
+  uint16_t size;
+  uint16_t stride;
+  uint16_t header_size;
+  uint32_t data_size;
+  uint8_t reserved[8];
+};
+static_assert(sizeof(WaveBankHeader) == 32, "Unexpected WaveBank header size");
+
+/**
+ * Storage policies for WaveBank tables. Samples are converted to float
+ * when they are read by the oscillator, and multiplied by the table scale
+ * if the format is SCALED.
+ */
+struct WaveBankFloat32 {
+  typedef float Sample;
+  static constexpr uint16_t FORMAT = WaveBankHeader::FORMAT_FLOAT32;
+  static constexpr bool SCALED = false;
+  static inline float toFloat(Sample s){
+    return s;
+  }
+  static inline Sample fromFloat(float f){
+    return f;
+  }
+};
+
+/**
+ * 16 bit integer samples, each table is normalized to its peak
+ */
+struct WaveBankInt16 {
+  typedef int16_t Sample;
+  static constexpr uint16_t FORMAT = WaveBankHeader::FORMAT_INT16;
+  static constexpr bool SCALED = true;
+  static inline float toFloat(Sample s){
+    return s;
+  }
+  static inline Sample fromFloat(float f){
+    return f < -32767 ? -32767 : f > 32767 ? 32767 : (Sample)lrintf(f);
+  }
+};
+
+/**
+ * IEEE half precision samples. Uses hardware conversion where compiler
+ * supports __fp16, otherwise bit manipulation valid for the range of
+ * audio samples (no infinities or NaNs).
+ */
+struct WaveBankFloat16 {
+  typedef uint16_t Sample;
+  static constexpr uint16_t FORMAT = WaveBankHeader::FORMAT_FLOAT16;
+  static constexpr bool SCALED = false;
+#ifdef __ARM_FP16_FORMAT_IEEE
+  static inline float toFloat(Sample s){
+    union { Sample s; __fp16 h; } u = { s };
+    return u.h;
+  }
+  static inline Sample fromFloat(float f){
+    union { __fp16 h; Sample s; } u = { (__fp16)f };
+    return u.s;
+  }
+#else
+  static inline float toFloat(Sample s){
+    // moving exponent to float position rebiases it by 2^112
+    union { uint32_t i; float f; } u = { uint32_t(s & 0x7fff) << 13 };
+    u.f *= 0x1p112f;
+    u.i |= uint32_t(s & 0x8000) << 16;
+    return u.f;
+  }
+  static inline Sample fromFloat(float f){
+    union { float f; uint32_t i; } u = { f };
+    uint32_t sign = (u.i >> 16) & 0x8000;
+    u.i &= 0x7fffffff;
+    u.f *= 0x1p-112f;
+    return sign | ((u.i + 0x1000) >> 13); // round to nearest
+  }
+#endif
+};
+
+template<size_t X, size_t Y, size_t Z, size_t SIZE, typename Storage = WaveBankFloat32>
 class WaveBank {
-protected:
+public:
+  typedef typename Storage::Sample Sample;
 #ifdef DDS_INTERPOLATE
-  float waves[X][Y][Z][SIZE+1];
+  static constexpr size_t STRIDE = SIZE+1;
 #else
-  float waves[X][Y][Z][SIZE];
+  static constexpr size_t STRIDE = SIZE;
 #endif
+  static constexpr size_t LENGTH = X*Y*Z*STRIDE;
+  static constexpr size_t SCALES_SIZE = Storage::SCALED ? X*Y*Z*sizeof(float) : 0;
+  static constexpr size_t DATA_SIZE = SCALES_SIZE + LENGTH*sizeof(Sample);
+protected:
+  float* scales;
+  Sample* waves;
+  uint8_t* allocated; // NULL if data is used in place
+  Resource* resource;
+  static size_t getIndex(size_t x, size_t y, size_t z){
+    return ((x%X)*Y + y%Y)*Z + z;
+  }
 public:
-  float* getWave(size_t x, size_t y, size_t z){
-    return waves[x%X][y%Y][z];
+  /**
+   * Data is laid out as in bank resource, scales followed by waves
+   */
+  WaveBank(uint8_t* data, uint8_t* allocated, Resource* resource = NULL)
+    : scales((float*)data), waves((Sample*)(data + SCALES_SIZE)),
+      allocated(allocated), resource(resource) {}
+  const Sample* getWave(size_t x, size_t y, size_t z){
+    return waves + getIndex(x, y, z)*STRIDE;
   }
-  static WaveBank<X, Y, Z, SIZE>* create(FloatArray wavetable);
-  static void destroy(WaveBank<X, Y, Z, SIZE>* obj);
+  float getScale(size_t x, size_t y, size_t z){
+    if(Storage::SCALED)
+      return scales[getIndex(x, y, z)];
+    return 1;
+  }
+  /**
+   * Store SIZE samples of wave, converted to storage format
+   */
+  void setWave(size_t x, size_t y, size_t z, FloatArray wave){
+    size_t index = getIndex(x, y, z);
+    Sample* dest = waves + index*STRIDE;
+    float scale = 1;
+    if(Storage::SCALED){
+      float peak = max(wave.getMaxValue(), -wave.getMinValue());
+      scale = peak > 0 ? peak/32767 : 1;
+      scales[index] = scale;
+    }
+    for(size_t i=0; i<SIZE; i++)
+      dest[i] = Storage::fromFloat(wave[i]/scale);
+#ifdef DDS_INTERPOLATE
+    dest[SIZE] = dest[0]; // set SIZE+1 sample to wrap around
+#endif
+  }
+  static WaveBank<X, Y, Z, SIZE, Storage>* create(FloatArray wavetable);
+  static WaveBank<X, Y, Z, SIZE, Storage>* load(const char* name);
+  static void destroy(WaveBank<X, Y, Z, SIZE, Storage>* obj);
 };
 
-template<size_t X, size_t Y, size_t Z, size_t SIZE>
+template<size_t X, size_t Y, size_t Z, size_t SIZE, typename Storage>
 class WaveBankFactory {
 private:
   FastFourierTransform *fourier;	
@@ -42,28 +181,22 @@ public:
     FloatArray::destroy(zeros);
     FastFourierTransform::destroy(fourier);
   }
-  void generate(WaveBank<X, Y, Z, SIZE>* bank, FloatArray sample, size_t x, size_t y){
+  void generate(WaveBank<X, Y, Z, SIZE, Storage>* bank, FloatArray sample, size_t x, size_t y){
     fft.clear();
     dest.clear();
     zeros.clear();
-    FloatArray dest(bank->getWave(x, y, 0), SIZE); // we borrow this to copy the input sample
     dest.copyFrom(sample); // zero-padding if sample.getSize() < SIZE
     fourier->fft(dest, fft); // destructive
     int fftoffs = fft.getSize();
     for(size_t i=0; i<Z; i++){
-      dest = FloatArray(bank->getWave(x, y, i), SIZE);
       fftoffs /= 2;
       fft.setMagnitude(zeros, fftoffs, (fft.getSize())-fftoffs);
       tmp.copyFrom(fft);
       fourier->ifft(tmp, dest);
-#ifdef DDS_INTERPOLATE
-      dest[SIZE] = dest[0]; // set SIZE+1 sample to wrap around
-#endif
-      // fftoffs /= 2;
-      // fft.setMagnitude(zeros, fftoffs, (fft.getSize())-fftoffs);
+      bank->setWave(x, y, i, dest);
     }
   }
-  void makeMatrix(WaveBank<X, Y, Z, SIZE>* bank, FloatArray samples) {
+  void makeMatrix(WaveBank<X, Y, Z, SIZE, Storage>* bank, FloatArray samples) {
     FloatArray sample;
     for(size_t x=0 ; x<X ; x++){
       for (size_t y=0 ; y<Y; y++){
@@ -74,29 +207,31 @@ public:
   }
 }; 
 
-template<size_t X, size_t Y, size_t Z, size_t SIZE>
+template<size_t X, size_t Y, size_t Z, size_t SIZE, typename Storage = WaveBankFloat32>
 class WaveBankOscillator : public Oscillator {
 protected:
   const float sr;
-  WaveBank<X, Y, Z, SIZE>* waves;
+  WaveBank<X, Y, Z, SIZE, Storage>* waves;
   float x = 0;
   float y = 0;
   float z = 0;
   float phase = 0;
   float incr = 0;
+  float last_x = 0;
+  float last_y = 0;
+  float last_z = 0;
+  typedef typename WaveBank<X, Y, Z, SIZE, Storage>::Sample Sample;
+  static constexpr size_t STRIDE = WaveBank<X, Y, Z, SIZE, Storage>::STRIDE;
 public:
-  WaveBankOscillator(WaveBank<X, Y, Z, SIZE>* wavebank, float sr): sr(sr), waves(wavebank) {}
-  WaveBank<X, Y, Z, SIZE>* getBank(){
+  WaveBankOscillator(WaveBank<X, Y, Z, SIZE, Storage>* wavebank, float sr): sr(sr), waves(wavebank) {}
+  WaveBank<X, Y, Z, SIZE, Storage>* getBank(){
     return waves;
   }
   void setFrequency(float freq){
     incr = freq*SIZE/sr;
-    /* z = freq*Z/sr; // really? find which wavetable corresponds to frequency */
-    // base frequency: incr=1 (incr=0 up to 187.5 Hz at SIZE=256, incr=6 up to 1312.5 Hz )
-    // incr=64 up to 12kHz, log2(64) == 6
-    // z = min(Z-1, log2f(incr+1));
-    z = max(0, min(Z-1, log2f(freq/SIZE+1)));
-    // debugMessage("freq/incr/z/", freq, incr, z);
+    // level i keeps harmonics below SIZE/2^(i+1), which reach Nyquist at
+    // incr = 2^(i-1). Fractional part crossfades with next, duller level.
+    z = max(0, min(Z-1, log2f(incr)+1));
   }
   float getFrequency(){
     return incr*sr/SIZE;
@@ -124,187 +259,195 @@ public:
     return y/Y;
   }
   float generate(float fm){
-    float sample = generate(fm);
+    float sample = generate();
     phase += fm;
     if(phase >= SIZE)
       phase -= SIZE;
+    else if(phase < 0)
+      phase += SIZE;
     return sample;
   }
   float generate(){
     size_t xi = x;
-    float xf = x-xi;
     size_t yi = y;
-    float yf = y-yi;
-    size_t zi = z; // just use bottom bandwidth-limited wavetable
-    float* wave00 = waves->getWave(xi, yi, zi);
-    float* wave01 = waves->getWave(xi+1, yi, zi);
-    float* wave10 = waves->getWave(xi, yi+1, zi);
-    float* wave11 = waves->getWave(xi+1, yi+1, zi);
-    size_t phi0 = phase; // phase goes from 0.0 to SIZE
-#ifdef DDS_INTERPOLATE
-    // interpolating samples
-    size_t phi1 = phi0+1;
-    float phf1 = phase-phi0; // fractional part
-    float phf0 = 1-phf1;
-    float s00 = wave00[phi0]*phf0 + wave00[phi1]*phf1;
-    float s01 = wave01[phi0]*phf0 + wave01[phi1]*phf1;
-    float s10 = wave10[phi0]*phf0 + wave10[phi1]*phf1;
-    float s11 = wave11[phi0]*phf0 + wave11[phi1]*phf1;
-#else
-    float s00 = wave00[phi0];
-    float s01 = wave01[phi0];
-    float s10 = wave10[phi0];
-    float s11 = wave11[phi0];
-#endif
-    s00 += (s10 - s00)*yf;
-    s01 += (s11 - s01)*yf;
-    s00 += (s01 - s00)*xf;
-    phase += incr;
-    if(phase >= SIZE)
-      phase -= SIZE;
-    return s00;
+    size_t zi = z;
+    float sample;
+    if(zi+1 < Z)
+      render<true>(&sample, 1, xi, yi, zi, x-xi, y-yi, z-zi, 0, 0, 0);
+    else
+      render<false>(&sample, 1, xi, yi, zi, x-xi, y-yi, 0, 0, 0, 0);
+    last_x = x;
+    last_y = y;
+    last_z = z;
+    return sample;
   }
   using Oscillator::generate;
-  // using SignalGenerator::generate;
-#if 0
+  /**
+   * Render a block while moving x, y and z linearly from the values used by
+   * previous block to the current ones. Block is split where a coordinate
+   * crosses a table boundary, so wave pointers are looked up once per
+   * segment instead of once per sample.
+   */
   void generate(FloatArray output){
     float* out = output.getData();
     size_t len = output.getSize();
-    size_t xi = x;
-    float xf = x-xi;
-    size_t yi = y;
-    float yf = y-yi;
-    size_t zi = z; // just use bottom bandwidth-limited wavetable
-    float* wave00 = waves->getWave(xi, yi, zi);
-    float* wave01 = waves->getWave(xi, yi+1, zi);
-    float* wave10 = waves->getWave(xi+1, yi, zi);
-    float* wave11 = waves->getWave(xi+1, yi+1, zi);
-    while(len--){
-      size_t zi0 = phase; // z is phase and goes from 0 to Z
-#ifdef DDS_INTERPOLATE
-      // interpolating samples
-      size_t zi1 = zi0+1;
-      float zf1 = phase-zi0; // fractional part
-      float zf0 = 1-zf1;
-      float s00 = wave00[zi0]*zf0 + wave00[zi1]*zf1;
-      float s01 = wave01[zi0]*zf0 + wave01[zi1]*zf1;
-      float s10 = wave10[zi0]*zf0 + wave10[zi1]*zf1;
-      float s11 = wave11[zi0]*zf0 + wave11[zi1]*zf1;
-#else
-      float s00 = wave00[zi0];
-      float s01 = wave01[zi0];
-      float s10 = wave10[zi0];
-      float s11 = wave11[zi0];
-#endif
-      s00 += (s10 - s00)*yf;
-      s01 += (s11 - s01)*yf;
-      s00 += (s01 - s00)*xf;
-      *out++ = s00;
-
-      phase += incr;
-      if(phase >= SIZE)
-	phase -= SIZE;
+    const float dx = (x-last_x)/len;
+    const float dy = (y-last_y)/len;
+    const float dz = (z-last_z)/len;
+    float cx = last_x;
+    float cy = last_y;
+    float cz = last_z;
+    while(len){
+      size_t xi = cx;
+      size_t yi = cy;
+      size_t zi = cz;
+      size_t n = getSegment(len, cx, xi, dx);
+      n = getSegment(n, cy, yi, dy);
+      n = getSegment(n, cz, zi, dz);
+      if(zi+1 < Z && (cz > zi || dz != 0))
+	render<true>(out, n, xi, yi, zi, cx-xi, cy-yi, cz-zi, dx, dy, dz);
+      else
+	render<false>(out, n, xi, yi, zi, cx-xi, cy-yi, 0, dx, dy, 0);
+      cx += dx*n;
+      cy += dy*n;
+      cz += dz*n;
+      out += n;
+      len -= n;
     }
+    last_x = x;
+    last_y = y;
+    last_z = z;
   }
-  void generate(float newx, float newy, float newz, float* out, size_t len){
-    // must be called with abs(newN-N)<1 for x, y, z
-    // ie change less than one table in one block
-    // and actually: int(N) == int(N+newN)
-    // ie no transitions in one block
-    // maybe set N = newN before calling if not true?
-    
-    // set increments based on new values
-    float incx = (newx-x)/len;
-    float incy = (newy-y)/len;
-    // float incz = (newz-z)/len;
-    float incz = (newz-z)/len;
-    
-    size_t xi = x;
-    float xf = x-xi;
-    size_t yi = y;
-    float yf = y-yi;
-    size_t zi = z; // just use bottom bandwidth-limited wavetable
-    // we should probably be interpolating in z also
-
-    // assuming we're not traversing tables in this block
-    // float* wave00 = waves[xi][yi][zi];
-    // float* wave01 = waves[xi][yi+1][zi];
-    // float* wave10 = waves[xi+1][yi][zi];
-    // float* wave11 = waves[xi+1][yi+1][zi];
-    float* wave00 = waves->getWave(xi, yi, zi);
-    float* wave01 = waves->getWave(xi, yi+1, zi);
-    float* wave10 = waves->getWave(xi+1, yi, zi);
-    float* wave11 = waves->getWave(xi+1, yi+1, zi);
-
-    while(len--){
-      size_t zi0 = phase; // z is phase and goes from 0 to Z
+protected:
+  /**
+   * Number of samples, at most len, before pos moving by step per sample
+   * leaves table index
+   */
+  static size_t getSegment(size_t len, float pos, size_t index, float step){
+    float n;
+    if(step > 0)
+      n = ceilf((index+1-pos)/step);
+    else if(step < 0)
+      n = floorf((pos-index)/-step)+1;
+    else
+      return len;
+    return n < 1 ? 1 : n < len ? size_t(n) : len;
+  }
+  static inline float read(const Sample* wave, size_t index, float frac){
 #ifdef DDS_INTERPOLATE
-      // interpolating samples
-      size_t zi1 = zi0+1;
-      float zf1 = phase-zi0; // fractional part
-      float zf0 = 1-zf1;
-      float s00 = wave00[zi0]*zf0 + wave00[zi1]*zf1;
-      float s01 = wave01[zi0]*zf0 + wave01[zi1]*zf1;
-      float s10 = wave10[zi0]*zf0 + wave10[zi1]*zf1;
-      float s11 = wave11[zi0]*zf0 + wave11[zi1]*zf1;
+    float s0 = Storage::toFloat(wave[index]);
+    float s1 = Storage::toFloat(wave[index+1]);
+    return s0 + (s1 - s0)*frac;
 #else
-      float s00 = wave00[zi0];
-      float s01 = wave01[zi0];
-      float s10 = wave10[zi0];
-      float s11 = wave11[zi0];
+    return Storage::toFloat(wave[index]);
 #endif
-      s00 += (s10 - s00)*yf;
-      s01 += (s11 - s01)*yf;
-      s00 += (s01 - s00)*xf;
-      *out++ = s00;
-
-      xf += incx;
-      yf += incy;
-      if(int(xf) != xi || int(yf) != yi){
-	// we've traversed a table boundary
-	xi = xf;
-	xf = x-xi;
-	yi = y;
-	yf = y-yi;
-	wave00 = waves->getWave(xi, yi, zi);
-	wave01 = waves->getWave(xi, yi+1, zi);
-	wave10 = waves->getWave(xi+1, yi, zi);
-	wave11 = waves->getWave(xi+1, yi+1, zi);
+  }
+  template<bool crossfade>
+  void render(float* out, size_t len, size_t xi, size_t yi, size_t zi,
+	      float xf, float yf, float zf, float dx, float dy, float dz){
+    const size_t zn = crossfade ? zi+1 : zi;
+    const Sample* w00 = waves->getWave(xi, yi, zi);
+    const Sample* w01 = waves->getWave(xi+1, yi, zi);
+    const Sample* w10 = waves->getWave(xi, yi+1, zi);
+    const Sample* w11 = waves->getWave(xi+1, yi+1, zi);
+    const Sample* n00 = waves->getWave(xi, yi, zn);
+    const Sample* n01 = waves->getWave(xi+1, yi, zn);
+    const Sample* n10 = waves->getWave(xi, yi+1, zn);
+    const Sample* n11 = waves->getWave(xi+1, yi+1, zn);
+    // table scales are folded into blend weights, 1 for unscaled storage
+    const float k00 = waves->getScale(xi, yi, zi);
+    const float k01 = waves->getScale(xi+1, yi, zi);
+    const float k10 = waves->getScale(xi, yi+1, zi);
+    const float k11 = waves->getScale(xi+1, yi+1, zi);
+    const float m00 = waves->getScale(xi, yi, zn);
+    const float m01 = waves->getScale(xi+1, yi, zn);
+    const float m10 = waves->getScale(xi, yi+1, zn);
+    const float m11 = waves->getScale(xi+1, yi+1, zn);
+    float ph = phase;
+    while(len--){
+      size_t phi = ph; // phase goes from 0.0 to SIZE
+      float phf = ph-phi;
+      // weights of bilinear blend, shared by both levels
+      float w1 = xf*(1-yf);
+      float w2 = (1-xf)*yf;
+      float w3 = xf*yf;
+      float w0 = 1-w1-w2-w3;
+      float sample = read(w00, phi, phf)*(w0*k00) + read(w01, phi, phf)*(w1*k01) +
+	read(w10, phi, phf)*(w2*k10) + read(w11, phi, phf)*(w3*k11);
+      if(crossfade){
+	float next = read(n00, phi, phf)*(w0*m00) + read(n01, phi, phf)*(w1*m01) +
+	  read(n10, phi, phf)*(w2*m10) + read(n11, phi, phf)*(w3*m11);
+	sample += (next - sample)*zf;
+	zf += dz;
       }
-      phase += incr;
-      incr += incz;
-      if(phase >= SIZE)
-	phase -= SIZE;
+      *out++ = sample;
+      xf += dx;
+      yf += dy;
+      ph += incr;
+      if(ph >= SIZE)
+	ph -= SIZE;
     }
-    x = newx;
-    y = newy;
-    incr = newz;
+    phase = ph;
   }
-#endif
-  
-  static WaveBankOscillator<X, Y, Z, SIZE>* create(WaveBank<X, Y, Z, SIZE>* bank, float sr){
-    return new WaveBankOscillator<X, Y, Z, SIZE>(bank, sr);
+public:
+  static WaveBankOscillator<X, Y, Z, SIZE, Storage>* create(WaveBank<X, Y, Z, SIZE, Storage>* bank, float sr){
+    return new WaveBankOscillator<X, Y, Z, SIZE, Storage>(bank, sr);
   }
-  static void destroy(WaveBankOscillator<X, Y, Z, SIZE>* obj){
+  static void destroy(WaveBankOscillator<X, Y, Z, SIZE, Storage>* obj){
     delete obj;
   }
 };
 
-template<size_t X, size_t Y, size_t Z, size_t SIZE>
-WaveBank<X, Y, Z, SIZE>* WaveBank<X, Y, Z, SIZE>::create(FloatArray wavetable){
-  WaveBankFactory<X, Y, Z, SIZE>* factory = new WaveBankFactory<X, Y, Z, SIZE>(SIZE);
-  WaveBank<X, Y, Z, SIZE>* bank = new WaveBank<X, Y, Z, SIZE>();
+template<size_t X, size_t Y, size_t Z, size_t SIZE, typename Storage>
+WaveBank<X, Y, Z, SIZE, Storage>* WaveBank<X, Y, Z, SIZE, Storage>::create(FloatArray wavetable){
+  WaveBankFactory<X, Y, Z, SIZE, Storage>* factory = new WaveBankFactory<X, Y, Z, SIZE, Storage>(SIZE);
+  uint8_t* data = new uint8_t[DATA_SIZE];
+  WaveBank<X, Y, Z, SIZE, Storage>* bank = new WaveBank<X, Y, Z, SIZE, Storage>(data, data);
   factory->makeMatrix(bank, wavetable);
   delete factory;
   return bank;
 }
 
-template<size_t X, size_t Y, size_t Z, size_t SIZE>
-void WaveBank<X, Y, Z, SIZE>::destroy(WaveBank<X, Y, Z, SIZE>* obj){
-  // for(int x=0; x<X; ++x)
-  //   for(int y=0; y<Y; ++y)
-  //     for(int z=0; z<Z; ++z)
-  // 	delete[] obj->getWave(x, y, z);
+/**
+ * Load bank precomputed by makewavebank.py. Memory mapped resources are
+ * used in place, otherwise waves are copied to RAM.
+ * @return NULL if resource is missing or doesn't match bank dimensions
+ * and storage format
+ */
+template<size_t X, size_t Y, size_t Z, size_t SIZE, typename Storage>
+WaveBank<X, Y, Z, SIZE, Storage>* WaveBank<X, Y, Z, SIZE, Storage>::load(const char* name){
+  Resource* resource = Resource::open(name);
+  if(resource == NULL)
+    return NULL;
+  WaveBankHeader header;
+  if(resource->read(&header, sizeof(header)) != sizeof(header) ||
+     header.magic != WaveBankHeader::MAGIC ||
+     header.version != WaveBankHeader::VERSION ||
+     header.format != Storage::FORMAT ||
+     header.x != X || header.y != Y || header.z != Z ||
+     header.size != SIZE || header.stride != STRIDE ||
+     header.data_size != DATA_SIZE ||
+     resource->getSize() < header.header_size + header.data_size){
+    Resource::destroy(resource);
+    return NULL;
+  }
+  if(resource->isMemoryMapped()){
+    uint8_t* data = resource->getData() + header.header_size;
+    return new WaveBank<X, Y, Z, SIZE, Storage>(data, NULL, resource);
+  }
+  uint8_t* data = new uint8_t[DATA_SIZE];
+  resource->read(data, header.data_size, header.header_size);
+  Resource::destroy(resource);
+  return new WaveBank<X, Y, Z, SIZE, Storage>(data, data);
+}
+
+template<size_t X, size_t Y, size_t Z, size_t SIZE, typename Storage>
+void WaveBank<X, Y, Z, SIZE, Storage>::destroy(WaveBank<X, Y, Z, SIZE, Storage>* obj){
+  if(obj == NULL)
+    return;
+  delete[] obj->allocated;
+  if(obj->resource != NULL)
+    Resource::destroy(obj->resource);
   delete obj;
 }
 
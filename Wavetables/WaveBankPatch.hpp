@@ -19,6 +19,9 @@
 #endif
 
 // #define DDS_INTERPOLATE
+// WaveBankInt16 or WaveBankFloat16 halve bank size, use makewavebank.py -f
+// int16 or -f float16 to precompute matching banks
+// #define WAVEBANK_STORAGE WaveBankInt16
 #include "WaveBank.h"
 
 #define SAMPLE_LEN 256
@@ -61,17 +64,27 @@ private:
         return bank;
     }
 
+    /**
+     * Use bank precomputed by makewavebank.py if it's available, otherwise
+     * bandlimit waves from WAV resource.
+     */
+    MorphBank* loadWavebank(const char* bank_name, const char* wav_name) {
+        MorphBank* bank = MorphBank::load(bank_name);
+        if (bank == NULL) {
+            FloatArray wt = createWavebank(wav_name);
+            bank = MorphBank::create(wt);
+            FloatArray::destroy(wt);
+        }
+        return bank;
+    }
+
 public:
     WaveBankPatch()
         : tempo1(getSampleRate() * 0.5)
         , tempo2(getSampleRate() * 0.25) {
 
-        FloatArray wt1 = createWavebank("wavetable1.wav");
-        MorphBank* bank1 = MorphBank::create(wt1);
-        FloatArray::destroy(wt1);
-        FloatArray wt2 = createWavebank("wavetable2.wav");
-        MorphBank* bank2 = MorphBank::create(wt2);
-        FloatArray::destroy(wt2);
+        bank1 = loadWavebank("wavebank1.bin", "wavetable1.wav");
+        bank2 = loadWavebank("wavebank2.bin", "wavetable2.wav");
 
         voices = MorphVoices::create(2, getBlockSize());
         for (int i = 0; i < VOICES; ++i)
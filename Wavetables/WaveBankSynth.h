@@ -1,6 +1,9 @@
 
-typedef WaveBank<NOF_X_WF, NOF_Y_WF, NOF_Z_WF, SAMPLE_LEN> MorphBank;
-typedef WaveBankOscillator<NOF_X_WF, NOF_Y_WF, NOF_Z_WF, SAMPLE_LEN> MorphOsc;
+#ifndef WAVEBANK_STORAGE
+#define WAVEBANK_STORAGE WaveBankFloat32
+#endif
+typedef WaveBank<NOF_X_WF, NOF_Y_WF, NOF_Z_WF, SAMPLE_LEN, WAVEBANK_STORAGE> MorphBank;
+typedef WaveBankOscillator<NOF_X_WF, NOF_Y_WF, NOF_Z_WF, SAMPLE_LEN, WAVEBANK_STORAGE> MorphOsc;
 
 class MorphSynth : public AbstractSynth {
 protected:
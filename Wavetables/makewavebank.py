@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+
+"""
+Build a precomputed WaveBank resource from a wavetable WAV file.
+
+Every wave is bandlimited to Z levels the same way as WaveBankFactory does
+at patch load: level i keeps harmonics below SIZE / 2^(i + 1). Samples are
+stored as float32, float16 or int16 with a scale per table. Output is
+a versioned binary bank that WaveBank::load() uses in place when resource
+storage is memory mapped, so no FFT work is left for the device.
+
+Input can be a plain WAV or a resource made by makeresource.py. Output is
+wrapped in the same resource header unless --raw is given.
+"""
+
+import argparse
+import os
+import struct
+import numpy
+
+BANK_MAGIC = b'WBNK'
+BANK_VERSION = 1
+BANK_HEADER_SIZE = 32
+FORMATS = {'float32': 0, 'int16': 1, 'float16': 2}
+
+RESOURCE_MAGIC = 0xDADADEED
+RESOURCE_NAME_SIZE = 24
+
+
+def read_wav(path):
+    with open(path, 'rb') as fobj:
+        data = fobj.read()
+    start = data.find(b'RIFF')
+    if start < 0 or data[start + 8:start + 12] != b'WAVE':
+        raise ValueError(f'{path} is not a WAV file')
+    pos = start + 12
+    fmt = None
+    while pos + 8 <= len(data):
+        chunk_id, chunk_size = struct.unpack_from('<4sI', data, pos)
+        body = data[pos + 8:pos + 8 + chunk_size]
+        if chunk_id == b'fmt ':
+            fmt = struct.unpack_from('<HHIIHH', body)
+        elif chunk_id == b'data':
+            if fmt is None:
+                raise ValueError('data chunk before fmt chunk')
+            code, channels, _, _, _, bits = fmt
+            if code == 1 and bits == 16:
+                samples = numpy.frombuffer(body, dtype='<i2') / 32768.0
+            elif code == 3 and bits == 32:
+                samples = numpy.frombuffer(body, dtype='<f4').astype(numpy.float64)
+            else:
+                raise ValueError(f'Unsupported WAV format {code}/{bits} bits')
+            # Only first channel is used, as in WavFile::createFloatArray(0)
+            return samples[::channels]
+        pos += 8 + chunk_size + (chunk_size & 1)
+    raise ValueError('No data chunk found')
+
+
+def bandlimit(wave, levels):
+    size = len(wave)
+    spectrum = numpy.fft.rfft(wave)
+    result = []
+    for i in range(levels):
+        harmonics = size >> (i + 1)
+        level = spectrum.copy()
+        # Nyquist is kept only by full bandwidth level
+        level[harmonics if i else harmonics + 1:] = 0
+        result.append(numpy.fft.irfft(level, size))
+    return result
+
+
+def make_bank(samples, x, y, z, size, interpolate, fmt='float32'):
+    stride = size + 1 if interpolate else size
+    if len(samples) < x * y * size:
+        raise ValueError(f'Need {x * y * size} samples, got {len(samples)}')
+    bank = numpy.zeros((x, y, z, stride))
+    for xi in range(x):
+        for yi in range(y):
+            offset = (xi * y + yi) * size
+            levels = bandlimit(samples[offset:offset + size], z)
+            for zi, wave in enumerate(levels):
+                bank[xi, yi, zi, :size] = wave
+                if interpolate:
+                    bank[xi, yi, zi, size] = wave[0]
+    if fmt == 'int16':
+        # Every table is normalized to its own peak, as WaveBank::setWave() does
+        peak = numpy.abs(bank).max(axis=3)
+        scales = numpy.where(peak > 0, peak / 32767, 1).astype('<f4')
+        waves = numpy.rint(bank / scales[..., None]).clip(-32767, 32767).astype('<i2')
+        data = scales.tobytes() + waves.tobytes()
+    elif fmt == 'float16':
+        data = bank.astype('<f2').tobytes()
+    else:
+        data = bank.astype('<f4').tobytes()
+    header = struct.pack('<4sHHHHHHHHI8x', BANK_MAGIC, BANK_VERSION, FORMATS[fmt],
+        x, y, z, size, stride, BANK_HEADER_SIZE, len(data))
+    assert len(header) == BANK_HEADER_SIZE
+    return header + data
+
+
+def main(args):
+    samples = read_wav(args.input)
+    data = make_bank(samples, args.x, args.y, args.z, args.size, args.interpolate, args.format)
+    if not args.raw:
+        name = (args.name or os.path.basename(args.output)).encode()
+        if len(name) >= RESOURCE_NAME_SIZE:
+            raise ValueError('Resource name is too long')
+        data = struct.pack(f'<II{RESOURCE_NAME_SIZE}s', RESOURCE_MAGIC, len(data), name) + data
+    with open(args.output, 'wb') as fobj:
+        fobj.write(data)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Precompute bandlimited WaveBank resource")
+    parser.add_argument('input', help='Wavetable WAV file or resource')
+    parser.add_argument('output', help='Output bank file')
+    parser.add_argument('-n', '--name', help='Resource name, output file name by default')
+    parser.add_argument('-x', type=int, default=8, help='Number of waves on X axis')
+    parser.add_argument('-y', type=int, default=8, help='Number of waves on Y axis')
+    parser.add_argument('-z', type=int, default=7, help='Number of bandlimited levels')
+    parser.add_argument('-s', '--size', type=int, default=256, help='Wave size')
+    parser.add_argument('-i', '--interpolate', action='store_true',
+        help='Add wrap around sample for builds with DDS_INTERPOLATE')
+    parser.add_argument('-f', '--format', choices=FORMATS.keys(), default='float32',
+        help='Sample storage, must match WaveBank storage policy')
+    parser.add_argument('--raw', action='store_true', help='Write bank without resource header')
+    main(parser.parse_args())